@@ -0,0 +1,45 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include "print.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace tycho {}
+using namespace tycho;
+
+namespace bench {
+// keeps a result alive so the optimizer cannot drop the work
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void *volatile sink{nullptr};
+    sink = &value;
+#endif
+}
+
+// Runs func count times after one warm up call and prints the time per
+// call, the rate, and MB/s when each call covers bytes of input.
+template <typename Func>
+inline auto run(const char *name, std::size_t count, Func func, std::size_t bytes = 0) {
+    using clock = std::chrono::steady_clock;
+    func();
+    const auto start = clock::now();
+    for (std::size_t pos = 0; pos < count; ++pos)
+        func();
+    const auto secs = std::chrono::duration<double>(clock::now() - start).count();
+    const auto ns = secs * 1e9 / double(count);
+    if (bytes)
+        print("{:<44} {:>10.1f} ns/op {:>14.0f} ops/s {:>10.1f} MB/s\n", name, ns, double(count) / secs, double(bytes) * double(count) / secs / 1e6);
+    else
+        print("{:<44} {:>10.1f} ns/op {:>14.0f} ops/s\n", name, ns, double(count) / secs);
+    return ns;
+}
+} // namespace bench
+#endif
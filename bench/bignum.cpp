@@ -0,0 +1,62 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "bignum.hpp"
+
+using namespace crypto;
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    for (const int bits : {256, 2048}) {
+        const auto count = bits > 256 ? std::size_t(200) : std::size_t(20000);
+        const auto mod = bignum_t::make_rand(bits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD);
+        const auto base = bignum_t::make_rand(bits - 8);
+        const auto exp = bignum_t::make_rand(bits);
+        const modulus_t modulus(mod);
+        const fixed_base_t fixed(modulus, base);
+        const auto label = [bits](const char *what) {
+            return fmt::format("modexp {} {}", bits, what);
+        };
+        bignum_t out;
+
+        // what each call paid before the shared context pool
+        bench::run(label("new BN_CTX per call").c_str(), count, [&] {
+            auto ctx = BN_CTX_new();
+            BN_mod_exp(out.get(), base.get(), exp.get(), mod.get(), ctx);
+            BN_CTX_free(ctx);
+            bench::keep(out);
+        });
+        bench::run(label("bignum_t::mod_exp").c_str(), count, [&] {
+            bench::keep(out.mod_exp(base, exp, mod));
+        });
+        bench::run(label("modulus_t").c_str(), count, [&] {
+            bench::keep(modulus.mod_exp(out, base, exp));
+        });
+        bench::run(label("modulus_t consttime").c_str(), count, [&] {
+            bench::keep(modulus.mod_exp(out, base, exp, true));
+        });
+        bench::run(label("fixed_base_t").c_str(), count, [&] {
+            bench::keep(fixed.exp(exp));
+        });
+    }
+
+    const auto mod = bignum_t::make_rand(2048, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD);
+    const auto base = bignum_t::make_rand(2000);
+    const modulus_t modulus(mod);
+
+    // a chain of modular products, as in a modexp inner loop
+    constexpr std::size_t steps = 100000;
+    auto acc = base % mod;
+    bench::run("modmul 2048 operators", steps, [&] {
+        acc = (acc * base) % mod;
+    });
+    bench::run("modmul 2048 in place", steps, [&] {
+        acc.mod_mul(acc, base, mod);
+    });
+    auto mont = modulus.to_mont(acc);
+    const auto mbase = modulus.to_mont(base);
+    bench::run("modmul 2048 montgomery", steps, [&] {
+        modulus.mont_mul(mont, mont, mbase);
+    });
+    bench::keep(mont);
+}
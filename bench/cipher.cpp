@@ -0,0 +1,40 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "cipher.hpp"
+
+#include <vector>
+
+using namespace crypto;
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    constexpr std::size_t packets = 100000;
+    const keyphrase_t key("packet key", nosalt, EVP_aes_256_gcm());
+    const uint8_t aad[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t tag[16];
+
+    for (const std::size_t size : {64, 256, 512, 1024, 1500}) {
+        std::vector<uint8_t> packet(size, 0x5a), sealed(size), opened(size);
+        nonce_t nonces(key.iv());
+        encrypt_t sender(key);
+        decrypt_t receiver(key);
+        const auto label = [size](const char *what) {
+            return fmt::format("{} {} byte packets", what, size);
+        };
+
+        bench::run(label("seal reused context").c_str(), packets, [&] {
+            sender.seal(nonces.next(), aad, sizeof(aad), packet.data(), size, sealed.data(), tag);
+        }, size);
+        sender.seal(nonces.at(0), aad, sizeof(aad), packet.data(), size, sealed.data(), tag);
+        bench::run(label("open reused context").c_str(), packets, [&] {
+            receiver.open(nonces.at(0), aad, sizeof(aad), sealed.data(), size, opened.data(), tag);
+        }, size);
+
+        // the per packet context and key schedule that reset() avoids
+        bench::run(label("seal new context").c_str(), packets / 10, [&] {
+            encrypt_t once(key);
+            once.seal(nonces.next(), aad, sizeof(aad), packet.data(), size, sealed.data(), tag);
+        }, size);
+    }
+}
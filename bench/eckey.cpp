@@ -0,0 +1,72 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "eckey.hpp"
+#include "sign.hpp"
+
+#include <string>
+
+using namespace crypto;
+
+namespace {
+template <typename Key>
+void sign_verify(const char *curve, const Key& key, EVP_PKEY *pub, std::size_t count) {
+    const std::string_view msg = "the quick brown fox jumps over the lazy dog";
+    const auto label = [curve](const char *what) {
+        return fmt::format("{} {}", curve, what);
+    };
+
+    sign_t signer(key.share());
+    signer.update(msg);
+    signer.finish();
+    const auto message = crypto::key_t(reinterpret_cast<const uint8_t *>(msg.data()), msg.size());
+    const auto signature = crypto::key_t(signer.data(), signer.size());
+
+    bench::run(label("sign").c_str(), count, [&] {
+        sign_t once(key.share());
+        once.update(msg);
+        bench::keep(once.finish());
+    });
+    bench::run(label("verify").c_str(), count, [&] {
+        bench::keep(verify(pub, message, signature));
+    });
+}
+} // namespace
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    constexpr std::size_t count = 500;
+
+    bench::run("secp521r1 keygen", count / 5, [] {
+        const eckey_t key;
+        bench::keep(key);
+    });
+    bench::run("ed25519 keygen", count, [] {
+        const ed25519_t key;
+        bench::keep(key);
+    });
+    bench::run("x25519 keygen", count, [] {
+        const x25519_t key;
+        bench::keep(key);
+    });
+
+    const eckey_t ec, ec_peer;
+    const pubkey_t ec_pub(ec.pub()), ec_peer_pub(ec_peer.pub());
+    sign_verify("secp521r1", ec, ec_pub.get(), count / 5);
+
+    const ed25519_t ed;
+    const pubkey_t ed_pub(ed.pub_raw(), "ED25519");
+    sign_verify("ed25519", ed, ed_pub.get(), count);
+
+    eckey_t local(ec);
+    bench::run("secp521r1 derive", count / 5, [&] {
+        bench::keep(local.derive(ec_peer_pub.get(), "session"));
+    });
+
+    x25519_t alice;
+    const x25519_t bob;
+    const pubkey_t bob_pub(bob.pub_raw(), "X25519");
+    bench::run("x25519 derive", count, [&] {
+        bench::keep(alice.derive(bob_pub.get(), "session", 32));
+    });
+}
@@ -0,0 +1,97 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "encoding.hpp"
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+// the per byte snprintf and strtoul conversions the kernels replaced
+void snprintf_encode(const uint8_t *in, std::size_t size, char *out) {
+    for (std::size_t pos = 0; pos < size; ++pos)
+        snprintf(out + pos * 2, 3, "%02x", in[pos]);
+}
+
+void strtoul_decode(const char *in, std::size_t size, uint8_t *out) {
+    char pair[3]{0};
+    for (std::size_t pos = 0; pos < size; ++pos) {
+        pair[0] = in[pos * 2];
+        pair[1] = in[pos * 2 + 1];
+        out[pos] = uint8_t(strtoul(pair, nullptr, 16));
+    }
+}
+
+void table_encode(const uint8_t *in, std::size_t size, char *out) {
+    for (std::size_t pos = 0; pos < size; ++pos) {
+        out[pos * 2] = detail::hex_lower_chars[in[pos] >> 4];
+        out[pos * 2 + 1] = detail::hex_lower_chars[in[pos] & 0x0f];
+    }
+}
+
+void table_decode(const char *in, std::size_t size, uint8_t *out) {
+    for (std::size_t pos = 0; pos < size; ++pos)
+        out[pos] = uint8_t((detail::hex_table[uint8_t(in[pos * 2])] << 4) | detail::hex_table[uint8_t(in[pos * 2 + 1])]);
+}
+} // namespace
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    for (const std::size_t size : {32, 4096}) {
+        const auto count = std::size_t(16 << 20) / size;
+        std::vector<uint8_t> bin(size), back(size);
+        for (std::size_t pos = 0; pos < size; ++pos)
+            bin[pos] = uint8_t(pos * 131);
+        std::string text(size * 2, '0');
+        const auto label = [size](const char *what) {
+            return fmt::format("{} {} bytes", what, size);
+        };
+
+        bench::run(label("encode snprintf").c_str(), count / 16, [&] {
+            snprintf_encode(bin.data(), size, text.data());
+            bench::keep(text);
+        }, size);
+        bench::run(label("encode table").c_str(), count, [&] {
+            table_encode(bin.data(), size, text.data());
+            bench::keep(text);
+        }, size);
+#ifdef TYCHO_ENCODING_X86
+        if (detail::has_ssse3())
+            bench::run(label("encode ssse3").c_str(), count, [&] {
+                detail::hex_encode_ssse3(bin.data(), size, text.data(), false);
+                bench::keep(text);
+            }, size);
+        if (detail::has_avx2())
+            bench::run(label("encode avx2").c_str(), count, [&] {
+                detail::hex_encode_avx2(bin.data(), size, text.data(), false);
+                bench::keep(text);
+            }, size);
+#endif
+        bench::run(label("encode hex_encode").c_str(), count, [&] {
+            hex_encode(bin.data(), size, text.data());
+            bench::keep(text);
+        }, size);
+
+        bench::run(label("decode strtoul").c_str(), count / 16, [&] {
+            strtoul_decode(text.data(), size, back.data());
+            bench::keep(back);
+        }, size);
+        bench::run(label("decode table").c_str(), count, [&] {
+            table_decode(text.data(), size, back.data());
+            bench::keep(back);
+        }, size);
+#ifdef TYCHO_ENCODING_X86
+        if (detail::has_ssse3())
+            bench::run(label("decode ssse3").c_str(), count, [&] {
+                detail::hex_decode_ssse3(text.data(), size, back.data());
+                bench::keep(back);
+            }, size);
+#endif
+        bench::run(label("decode hex_decode").c_str(), count, [&] {
+            hex_decode(text, back.data(), back.size());
+            bench::keep(back);
+        }, size);
+    }
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+
+#include <vector>
+#include <thread>
+#include <ctime>
+#include <fcntl.h>
+
+namespace {
+// cpu time of the calling thread, so a writer sharing the core is not counted
+auto thread_ns() {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (double(now.tv_sec) * 1e9) + double(now.tv_nsec);
+}
+
+// caller side cost of each log call from one or more threads at once
+template <typename Func>
+void producers(const char *name, unsigned threads, std::size_t count, Func func) {
+    using clock = std::chrono::steady_clock;
+    std::vector<std::thread> workers;
+    std::vector<double> wall(threads), cpu(threads);
+    for (unsigned id = 0; id < threads; ++id) {
+        workers.emplace_back([&, id] {
+            func(0); // first call from a thread sets up its ring
+            const auto start = clock::now();
+            const auto used = thread_ns();
+            for (std::size_t pos = 1; pos <= count; ++pos)
+                func(pos);
+            cpu[id] = (thread_ns() - used) / double(count);
+            wall[id] = std::chrono::duration<double, std::nano>(clock::now() - start).count() / double(count);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    auto wall_ns = 0.0, cpu_ns = 0.0;
+    for (unsigned id = 0; id < threads; ++id) {
+        wall_ns += wall[id] / threads;
+        cpu_ns += cpu[id] / threads;
+    }
+    print("{:<44} {:>10.1f} ns/op {:>10.1f} ns cpu, {} threads\n", name, wall_ns, cpu_ns, threads);
+}
+} // namespace
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    const auto fd = ::open("/dev/null", O_WRONLY);
+    constexpr std::size_t calls = 200000;
+    system_logger logger;
+    logger.set(1);
+
+    // rings hold every call, so this is the producer cost and not drops
+    logger.async(1 << 24, log_policy::drop, fd);
+    for (auto threads : {1U, 2U, 4U}) {
+        producers("record 3 args", threads, calls / threads, [&logger](std::size_t pos) {
+            TYCHO_RECORD(logger, log_async::notice, "request {} status {} bytes {}", pos, 200, 1024.5);
+        });
+        logger.flush();
+    }
+    producers("record text arg", 1, calls, [&logger](std::size_t pos) {
+        TYCHO_RECORD(logger, log_async::warn, "peer {} closed {}", "gateway.example.net", pos);
+    });
+    logger.flush();
+    producers("notice formatted on caller", 1, calls, [&logger](std::size_t pos) {
+        logger.notice("request {} status {} bytes {}", pos, 200, 1024.5);
+    });
+    logger.flush();
+    print("dropped {}\n", logger.dropped());
+    logger.sync();
+    ::close(fd);
+}
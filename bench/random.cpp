@@ -0,0 +1,54 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "random.hpp"
+
+using namespace crypto;
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    constexpr std::size_t count = 1000000;
+    uint64_t word{0};
+    uint8_t block[4096];
+
+    // small draws, where the per-thread pool replaces a drbg call each
+    bench::run("RAND_bytes 8 bytes", count / 10, [&] {
+        RAND_bytes(reinterpret_cast<uint8_t *>(&word), sizeof(word));
+        bench::keep(word);
+    }, sizeof(word));
+    bench::run("rand() pooled 8 bytes", count, [&] {
+        rand(word);
+        bench::keep(word);
+    }, sizeof(word));
+    bench::run("xoshiro 8 bytes", count, [&] {
+        word = fast_random()();
+        bench::keep(word);
+    }, sizeof(word));
+
+    // bulk fill
+    bench::run("RAND_bytes 4096 bytes", count / 100, [&] {
+        RAND_bytes(block, sizeof(block));
+        bench::keep(block);
+    }, sizeof(block));
+    bench::run("fast_fill 4096 bytes", count / 100, [&] {
+        fast_fill(block, sizeof(block));
+        bench::keep(block);
+    }, sizeof(block));
+
+    // bounded integers, against the old per call mt19937 setup
+    bench::run("random_device + mt19937 per call", count / 1000, [&] {
+        std::random_device device;
+        std::mt19937 gen(device());
+        std::uniform_int_distribution<int> dist(1, 6);
+        bench::keep(dist(gen));
+    });
+    bench::run("random_dist(1, 6)", count, [&] {
+        bench::keep(random_dist(1, 6));
+    });
+    bench::run("secure_range(6)", count, [&] {
+        bench::keep(secure_range(6));
+    });
+    bench::run("fast_range(6)", count, [&] {
+        bench::keep(fast_range(6));
+    });
+}
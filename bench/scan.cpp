@@ -0,0 +1,129 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "scan.hpp"
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cctype>
+
+namespace {
+// the digit at a time parsers that from_chars and swar replaced
+auto old_value(std::string_view& text, uint64_t max) {
+    uint64_t value = 0;
+    while (!text.empty() && isdigit(text.front())) {
+        value *= 10;
+        value += uint64_t(text.front() - '0');
+        if (value > max) {
+            value /= 10;
+            break;
+        }
+        text.remove_prefix(1);
+    }
+    return value;
+}
+
+auto old_real(std::string_view text) {
+    auto number = double(old_value(text, UINT64_MAX));
+    double divisor = 1.0;
+    if (!text.empty() && text.front() == '.') {
+        text.remove_prefix(1);
+        while (!text.empty() && isdigit(text.front())) {
+            divisor /= 10;
+            number += (text.front() - '0') * divisor;
+            text.remove_prefix(1);
+        }
+    }
+    if (!text.empty() && (text.front() == 'e' || text.front() == 'E')) {
+        text.remove_prefix(1);
+        bool negative = false;
+        if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
+            negative = (text.front() == '-');
+            text.remove_prefix(1);
+        }
+        auto exponent = int(old_value(text, 2147483647));
+        number *= std::pow(10, negative ? -exponent : exponent);
+    }
+    return number;
+}
+
+auto old_hex(std::string_view text) {
+    uint64_t val = 0;
+    while (!text.empty()) {
+        auto pos = scan::hex_digits.find(char(tolower(text.front())));
+        if (pos > 15) break;
+        val = (val << 4) | pos;
+        text.remove_prefix(1);
+    }
+    return val;
+}
+
+template <typename Func>
+void parse_all(const char *name, const std::vector<std::string>& inputs, Func func) {
+    std::size_t bytes = 0;
+    for (const auto& input : inputs)
+        bytes += input.size();
+    bench::run(name, 2000, [&] {
+        for (const auto& input : inputs)
+            bench::keep(func(input));
+    }, bytes);
+}
+} // namespace
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    std::vector<std::string> reals, decimals, hexes, integers;
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    for (auto count = 0; count < 1000; ++count) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto word = seed >> 11;
+        integers.push_back(std::to_string(word % 10000000000000ULL));
+        decimals.push_back(fmt::format("{}.{:06}", word % 100000, (word >> 20) % 1000000));
+        reals.push_back(fmt::format("{:.15g}", double(word % 1000000) * 1.234567e-3 * std::pow(10.0, double(int(word % 40) - 20))));
+        hexes.push_back(fmt::format("{:x}", word & 0xffffffffULL));
+    }
+
+    parse_all("get_unsigned<uint64_t> old digit loop", integers, [](std::string_view text) {
+        return old_value(text, UINT64_MAX);
+    });
+    parse_all("get_unsigned<uint64_t> strtoull", integers, [](const std::string& text) {
+        return strtoull(text.c_str(), nullptr, 10);
+    });
+    parse_all("get_unsigned<uint64_t> swar", integers, [](const std::string& text) {
+        return get_unsigned<uint64_t>(text);
+    });
+
+    parse_all("get_decimal old divisor loop", decimals, [](const std::string& text) {
+        return old_real(text);
+    });
+    parse_all("get_decimal strtod", decimals, [](const std::string& text) {
+        return strtod(text.c_str(), nullptr);
+    });
+    parse_all("get_decimal single pass", decimals, [](const std::string& text) {
+        return get_decimal(text);
+    });
+
+    parse_all("get_real old pow", reals, [](const std::string& text) {
+        return old_real(text);
+    });
+    parse_all("get_real strtod", reals, [](const std::string& text) {
+        return strtod(text.c_str(), nullptr);
+    });
+    parse_all("get_real single pass", reals, [](const std::string& text) {
+        return get_real(text);
+    });
+
+    parse_all("get_hex old digit find", hexes, [](const std::string& text) {
+        return old_hex(text);
+    });
+    parse_all("get_hex table", hexes, [](const std::string& text) {
+        return get_hex<uint32_t>(text);
+    });
+
+    // how often the old parsers missed the correctly rounded value
+    std::size_t inexact = 0;
+    for (const auto& text : reals)
+        inexact += old_real(text) != strtod(text.c_str(), nullptr);
+    print("old get_real results not correctly rounded: {} of {}\n", inexact, reals.size());
+}
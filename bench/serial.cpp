@@ -0,0 +1,115 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "serial.hpp"
+
+#include <string>
+#include <algorithm>
+
+#if __has_include(<termios.h>)
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+namespace {
+// Echoes everything the serial side writes back to it, standing in for a
+// device on the far end of a pty pair.
+void echo_peer(int master, const std::atomic<bool>& running) {
+    char buf[4096];
+    while (running) {
+        struct pollfd pfd{};
+        pfd.fd = master;
+        pfd.events = POLLIN;
+        if (::poll(&pfd, 1, 20) < 1) continue;
+        auto count = ::read(master, buf, sizeof(buf));
+        if (count <= 0) continue;
+        for (ssize_t pos = 0; pos < count;) {
+            auto sent = ::write(master, buf + pos, std::size_t(count - pos));
+            if (sent > 0) pos += sent;
+        }
+    }
+}
+
+auto get_all(const serial_t& port, char *out, std::size_t size) {
+    std::size_t total = 0;
+    while (total < size) {
+        auto count = port.get(out + total, size - total);
+        if (!count) return false;
+        total += count;
+    }
+    return true;
+}
+
+// Round trip latency and bulk throughput through the echo peer.
+auto measure(const serial_t& port, const char *mode, std::size_t frame, bool lines) {
+    using clock = std::chrono::steady_clock;
+    std::string out(frame, 'a'), back(frame, 0);
+    if (lines)
+        out.back() = '\n';
+
+    constexpr auto rounds = 50U;
+    auto start = clock::now();
+    for (auto count = 0U; count < rounds; ++count) {
+        if (port.put(out) != frame || !get_all(port, back.data(), frame) || back != out) return false;
+    }
+    const auto rtt = std::chrono::duration<double, std::micro>(clock::now() - start).count() / rounds;
+
+    const auto total = std::min<std::size_t>(256 * 1024, frame * 2048);
+    start = clock::now();
+    for (std::size_t sent = 0; sent < total; sent += frame) {
+        if (port.put(out.data(), frame) != frame || !get_all(port, back.data(), frame)) return false;
+    }
+    const auto secs = std::chrono::duration<double>(clock::now() - start).count();
+    print("serial {} frame {}: {:.1f} us round trip, {:.2f} MB/s\n", mode, frame, rtt, double(total) / secs / 1e6);
+    return true;
+}
+} // namespace
+
+// pty pair, so no hardware is needed
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    auto master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) || unlockpt(master)) {
+        print(std::cerr, "serial: no pty available\n");
+        return 1;
+    }
+
+    serial_t port(ptsname(master));
+    if (!port) {
+        print(std::cerr, "serial: cannot open {}\n", ptsname(master));
+        return 1;
+    }
+
+    auto result = 0;
+    std::atomic<bool> running{true};
+    std::thread peer(echo_peer, master, std::cref(running));
+    const auto check = [&result](bool ok) {
+        if (!ok)
+            result = 1;
+    };
+
+    for (auto frame : {std::size_t(1), std::size_t(16), std::size_t(64), std::size_t(255)}) {
+        port.timed_mode(frame, 10);
+        check(measure(port, "timed", frame, false));
+    }
+    port.timed_mode(255, 1);
+    check(measure(port, "bulk", 4096, false));
+    for (auto frame : {std::size_t(16), std::size_t(80), std::size_t(255)}) {
+        port.line_mode("\n");
+        check(measure(port, "line", frame, true));
+    }
+    running = false;
+    peer.join();
+
+    port.close();
+    ::close(master);
+    if (result)
+        print(std::cerr, "serial: echo round trip failed\n");
+    return result;
+}
+#else
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    print("serial: needs termios\n");
+}
+#endif
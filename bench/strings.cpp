@@ -0,0 +1,81 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#include "bench.hpp"
+#include "strings.hpp"
+
+#include <string>
+#include <algorithm>
+#include <cctype>
+
+namespace {
+// the locale based per character loops the ascii kernels replaced
+auto locale_upper(std::string_view text) {
+    auto out = std::string{text};
+    std::transform(out.begin(), out.end(), out.begin(), ::toupper);
+    return out;
+}
+
+auto locale_eq_case(std::string_view s1, std::string_view s2) {
+    if (s1.size() != s2.size()) return false;
+    for (std::size_t pos = 0; pos < s1.size(); ++pos) {
+        if (tolower(s1[pos]) != tolower(s2[pos])) return false;
+    }
+    return true;
+}
+} // namespace
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    std::string ascii, mixed;
+    while (ascii.size() < 4096)
+        ascii += "The Quick Brown Fox Jumps Over The Lazy Dog 0123456789. ";
+    ascii.resize(4096);
+    while (mixed.size() < 4096)
+        mixed += "Grüße aus Köln, ĉu vi parolas? 日本語のテキスト, emoji \xf0\x9f\x98\x80 ok. ";
+    mixed.resize(4090);
+    while (!u8valid(mixed))
+        mixed.pop_back();
+    const auto folded = lower_case(ascii);
+    const auto needle = std::string_view("LAZY DOG 0123456789. tHE qUICK bROWN fOX jUMPS oVER xyz");
+    constexpr std::size_t count = 20000;
+
+    bench::run("upper_case toupper per char 4096", count, [&] {
+        bench::keep(locale_upper(ascii));
+    }, ascii.size());
+    bench::run("upper_case ascii kernel 4096", count, [&] {
+        bench::keep(upper_case(ascii));
+    }, ascii.size());
+
+    bench::run("eq_case tolower per char 4096", count, [&] {
+        bench::keep(locale_eq_case(ascii, folded));
+    }, ascii.size());
+    bench::run("eq_case ascii kernel 4096", count, [&] {
+        bench::keep(eq_case(ascii, folded));
+    }, ascii.size());
+    bench::run("find_case missing needle 4096", count, [&] {
+        bench::keep(find_case(ascii, needle));
+    }, ascii.size());
+
+    for (const auto& [name, text] : {std::pair{"ascii", std::string_view(ascii)}, std::pair{"mixed", std::string_view(mixed)}}) {
+        const auto label = [name = name, size = text.size()](const char *what) {
+            return fmt::format("{} {} {}", what, name, size);
+        };
+        const auto bytes = reinterpret_cast<const uint8_t *>(text.data());
+        bench::run(label("u8verify").c_str(), count, [&] {
+            bench::keep(u8verify(text));
+        }, text.size());
+        bench::run(label("u8valid scalar").c_str(), count, [&] {
+            bench::keep(detail::u8valid_scalar(bytes, text.size()));
+        }, text.size());
+#ifdef TYCHO_STRINGS_X86
+        if (detail::cpu_ssse3())
+            bench::run(label("u8valid ssse3").c_str(), count, [&] {
+                bench::keep(detail::u8valid_ssse3(bytes, text.size()));
+            }, text.size());
+        if (detail::cpu_avx2())
+            bench::run(label("u8valid avx2").c_str(), count, [&] {
+                bench::keep(detail::u8valid_avx2(bytes, text.size()));
+            }, text.size());
+#endif
+    }
+}
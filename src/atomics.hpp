@@ -4,11 +4,19 @@
 #ifndef TYCHO_ATOMICS_HPP_
 #define TYCHO_ATOMICS_HPP_
 
+#include "memory.hpp"
+
 #include <atomic>
 #include <optional>
 #include <type_traits>
 #include <stdexcept>
 #include <list>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
 
 #if defined(_MSC_VER)
 #include <intrin.h>
@@ -482,6 +490,161 @@ private:
         return std::hash<K>()(key) % S;
     }
 };
+
+// Interned strings live in pager memory until the interner is destroyed,
+// so symbols compare by address and views stay valid without ownership.
+class symbol_t final {
+public:
+    symbol_t() noexcept = default;
+
+    explicit operator bool() const noexcept {
+        return entry_ != nullptr;
+    }
+
+    auto operator!() const noexcept {
+        return entry_ == nullptr;
+    }
+
+    auto operator==(const symbol_t& other) const noexcept {
+        return entry_ == other.entry_;
+    }
+
+    auto operator!=(const symbol_t& other) const noexcept {
+        return entry_ != other.entry_;
+    }
+
+    auto view() const noexcept {
+        if (!entry_) return std::string_view{};
+        return std::string_view(entry_->text, entry_->size);
+    }
+
+    auto c_str() const noexcept -> const char * {
+        return entry_ ? entry_->text : "";
+    }
+
+    auto size() const noexcept -> std::size_t {
+        return entry_ ? entry_->size : 0;
+    }
+
+    // dense id in order of interning, usable as a table index
+    auto id() const noexcept -> uint32_t {
+        return entry_ ? entry_->id : UINT32_MAX;
+    }
+
+    auto hash() const noexcept -> std::size_t {
+        return entry_ ? entry_->hash : 0;
+    }
+
+private:
+    friend class interner_t;
+
+    struct entry_t {
+        std::atomic<const entry_t *> next{nullptr};
+        std::size_t hash{0};
+        const char *text{nullptr};
+        uint32_t size{0}, id{0};
+    };
+
+    const entry_t *entry_{nullptr};
+
+    explicit symbol_t(const entry_t *entry) noexcept : entry_(entry) {}
+};
+
+class interner_t final {
+public:
+    interner_t(const interner_t&) = delete;
+    auto operator=(const interner_t&) -> auto& = delete;
+
+    explicit interner_t(std::size_t buckets = 4096, std::size_t page = 16384) : pager_(mempager::aligned_page(page)), mask_(mempager::aligned_size(buckets) - 1), table_(new std::atomic<const entry_t *>[mask_ + 1]) {
+        if (!buckets) throw std::invalid_argument("Interner needs buckets");
+        for (std::size_t pos = 0; pos <= mask_; ++pos)
+            table_[pos].store(nullptr, std::memory_order_relaxed);
+    }
+
+    explicit operator bool() const noexcept {
+        return count_.load(std::memory_order_relaxed) > 0;
+    }
+
+    auto operator!() const noexcept {
+        return count_.load(std::memory_order_relaxed) == 0;
+    }
+
+    auto operator()(std::string_view str) {
+        return intern(str);
+    }
+
+    // lock free; an empty symbol if never interned
+    auto find(std::string_view str) const noexcept {
+        auto hash = std::hash<std::string_view>()(str);
+        return symbol_t(search(table_[hash & mask_].load(std::memory_order_acquire), str, hash));
+    }
+
+    // existing entries resolve lock free, new ones are added under a
+    // writer lock; an empty symbol if str is larger than a pager page
+    auto intern(std::string_view str) -> symbol_t {
+        auto hash = std::hash<std::string_view>()(str);
+        auto& bucket = table_[hash & mask_];
+        auto head = bucket.load(std::memory_order_acquire);
+        auto found = search(head, str, hash);
+        if (found || str.size() >= UINT32_MAX) return symbol_t(found);
+
+        const std::lock_guard lock(lock_);
+        auto latest = bucket.load(std::memory_order_acquire);
+        if (latest != head && (found = search(latest, str, hash)) != nullptr) return symbol_t(found);
+        auto text = pager_.dup(str);
+        if (!text) return {};
+        auto mem = pager_.make<entry_t>();
+        if (!mem) return {};
+        auto made = new (mem) entry_t;
+        made->next.store(latest, std::memory_order_relaxed);
+        made->hash = hash;
+        made->text = text;
+        made->size = uint32_t(str.size());
+        made->id = uint32_t(count_.load(std::memory_order_relaxed));
+        bucket.store(made, std::memory_order_release);
+        count_.fetch_add(1, std::memory_order_release);
+        return symbol_t(made);
+    }
+
+    auto view(std::string_view str) {
+        return intern(str).view();
+    }
+
+    auto contains(std::string_view str) const noexcept {
+        return static_cast<bool>(find(str));
+    }
+
+    auto size() const noexcept {
+        return count_.load(std::memory_order_acquire);
+    }
+
+    auto empty() const noexcept {
+        return size() == 0;
+    }
+
+    // bytes of pager memory holding interned strings
+    auto used() const noexcept {
+        const std::lock_guard lock(lock_);
+        return pager_.used();
+    }
+
+private:
+    using entry_t = symbol_t::entry_t;
+
+    mutable std::mutex lock_;
+    mempager pager_;
+    std::size_t mask_;
+    std::unique_ptr<std::atomic<const entry_t *>[]> table_;
+    std::atomic<std::size_t> count_{0};
+
+    static auto search(const entry_t *entry, std::string_view str, std::size_t hash) noexcept -> const entry_t * {
+        while (entry) {
+            if (entry->hash == hash && entry->size == str.size() && !memcmp(entry->text, str.data(), str.size())) return entry;
+            entry = entry->next.load(std::memory_order_acquire);
+        }
+        return nullptr;
+    }
+};
 } // namespace tycho::atomic
 
 namespace tycho {
@@ -666,4 +829,13 @@ private:
     T& ref;
 };
 } // namespace tycho
+
+namespace std {
+template <>
+struct hash<tycho::atomic::symbol_t> {
+    auto operator()(const tycho::atomic::symbol_t& obj) const noexcept {
+        return obj.hash();
+    }
+};
+} // namespace std
 #endif
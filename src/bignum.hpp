@@ -7,6 +7,9 @@
 #include <string>
 #include <utility>
 #include <memory>
+#include <vector>
+#include <limits>
+#include <charconv>
 #include <cstdint>
 #include <openssl/bn.h>
 
@@ -15,12 +18,12 @@ using key_t = std::pair<const uint8_t *, std::size_t>;
 
 class bignum_t final {
 public:
-    bignum_t() noexcept : ctx_(BN_CTX_new()), num_(BN_new()) {}
+    bignum_t() noexcept : num_(BN_new()) {}
 
     // cppcheck-suppress noExplicitConstructor
-    bignum_t(BIGNUM *bn) noexcept : ctx_(BN_CTX_new()), num_(bn) {}
+    bignum_t(BIGNUM *bn) noexcept : num_(bn) {}
 
-    explicit bignum_t(long value) noexcept : ctx_(BN_CTX_new()), num_(BN_new()) {
+    explicit bignum_t(long value) noexcept : num_(BN_new()) {
         if (value < 0) {
             BN_set_word(num_, -value);
             BN_set_negative(num_, 1);
@@ -28,17 +31,17 @@ public:
             BN_set_word(num_, value);
     }
 
-    bignum_t(bignum_t&& from) noexcept : ctx_(from.ctx_), num_(from.num_) {
+    bignum_t(bignum_t&& from) noexcept : num_(from.num_) {
         from.reset();
     }
 
-    bignum_t(const bignum_t& copy) noexcept : ctx_(BN_CTX_new()), num_(BN_dup(copy.num_)) {}
+    bignum_t(const bignum_t& copy) noexcept : num_(BN_dup(copy.num_)) {}
 
     // cppcheck-suppress noExplicitConstructor
-    bignum_t(const key_t& key) noexcept : ctx_(BN_CTX_new()), num_(BN_bin2bn(key.first, int(key.second), nullptr)) {}
+    bignum_t(const key_t& key) noexcept : num_(BN_bin2bn(key.first, int(key.second), nullptr)) {}
 
     // cppcheck-suppress noExplicitConstructor
-    bignum_t(const std::string& text) noexcept : ctx_(BN_CTX_new()) {
+    bignum_t(const std::string& text) noexcept {
         BN_dec2bn(&num_, text.c_str());
         if (!num_)
             num_ = BN_new();
@@ -46,8 +49,6 @@ public:
 
     ~bignum_t() {
         release();
-        if (ctx_)
-            BN_CTX_free(ctx_);
     }
 
     explicit operator BIGNUM *() const noexcept {
@@ -71,12 +72,7 @@ public:
     }
 
     auto operator=(bignum_t&& from) noexcept -> auto& {
-        release();
-        if (ctx_)
-            BN_CTX_free(ctx_);
-        ctx_ = from.ctx_;
-        num_ = from.num_;
-        from.reset();
+        std::swap(num_, from.num_);
         return *this;
     }
 
@@ -84,16 +80,11 @@ public:
         if (&copy == this)
             return *this;
 
-        release();
-        if (ctx_)
-            BN_CTX_free(ctx_);
-        num_ = BN_dup(copy.num_);
-        ctx_ = BN_CTX_new();
+        BN_copy(num_, copy.num_);
         return *this;
     }
 
     auto operator=(long value) noexcept -> auto& {
-        release();
         if (value < 0) {
             BN_set_word(num_, -value);
             BN_set_negative(num_, 1);
@@ -157,8 +148,7 @@ public:
     }
 
     auto operator+=(const bignum_t& add) const noexcept -> auto& {
-        const bignum_t tmp(*this);
-        BN_add(num_, tmp.num_, add.num_);
+        BN_add(num_, num_, add.num_);
         return *this;
     }
 
@@ -180,8 +170,7 @@ public:
     }
 
     auto operator-=(const bignum_t& sub) const noexcept -> auto& {
-        const bignum_t tmp(*this);
-        BN_sub(num_, tmp.num_, sub.num_);
+        BN_sub(num_, num_, sub.num_);
         return *this;
     }
 
@@ -192,7 +181,7 @@ public:
 
     auto operator*(const bignum_t& mul) const noexcept {
         bignum_t result;
-        BN_mul(result.num_, num_, mul.num_, mul.ctx_);
+        BN_mul(result.num_, num_, mul.num_, context());
         return result;
     }
 
@@ -203,8 +192,7 @@ public:
     }
 
     auto operator*=(const bignum_t& mul) const noexcept -> auto& {
-        const bignum_t tmp(*this);
-        BN_mul(num_, tmp.num_, mul.num_, mul.ctx_);
+        BN_mul(num_, num_, mul.num_, context());
         return *this;
     }
 
@@ -215,7 +203,7 @@ public:
 
     auto operator/(const bignum_t& div) const noexcept {
         bignum_t result;
-        BN_div(result.num_, nullptr, num_, div.num_, div.ctx_);
+        BN_div(result.num_, nullptr, num_, div.num_, context());
         return result;
     }
 
@@ -226,8 +214,7 @@ public:
     }
 
     auto operator/=(const bignum_t& div) const noexcept -> auto& {
-        const bignum_t tmp(*this);
-        BN_div(num_, nullptr, tmp.num_, div.num_, div.ctx_);
+        BN_div(num_, nullptr, num_, div.num_, context());
         return *this;
     }
 
@@ -238,7 +225,7 @@ public:
 
     auto operator%(const bignum_t& mod) const noexcept {
         bignum_t result;
-        BN_div(nullptr, result.num_, num_, mod.num_, mod.ctx_);
+        BN_div(nullptr, result.num_, num_, mod.num_, context());
         return result;
     }
 
@@ -249,8 +236,7 @@ public:
     }
 
     auto operator%=(const bignum_t& mod) const noexcept -> auto& {
-        const bignum_t tmp(*this);
-        BN_div(nullptr, num_, tmp.num_, mod.num_, mod.ctx_);
+        BN_div(nullptr, num_, num_, mod.num_, context());
         return *this;
     }
 
@@ -310,24 +296,70 @@ public:
     auto operator^(long exp) const noexcept {
         bignum_t result(*this);
         const bignum_t exponent(exp);
-        BN_exp(result.num_, num_, exponent.num_, exponent.ctx_);
+        BN_exp(result.num_, num_, exponent.num_, context());
         return result;
     }
 
     auto operator^(const bignum_t& exp) const noexcept {
         bignum_t result(*this);
-        BN_exp(result.num_, num_, exp.num_, exp.ctx_);
+        BN_exp(result.num_, num_, exp.num_, context());
         return result;
     }
 
     auto operator^=(const bignum_t& exp) const noexcept -> auto& {
-        BN_exp(num_, num_, exp.num_, exp.ctx_);
+        BN_exp(num_, num_, exp.num_, context());
         return *this;
     }
 
     auto operator^=(long exp) const noexcept -> auto& {
         const bignum_t exponent(exp);
-        BN_exp(num_, num_, exponent.num_, exponent.ctx_);
+        BN_exp(num_, num_, exponent.num_, context());
+        return *this;
+    }
+
+    // fused operations write into this object without temporaries
+    auto mul_add(const bignum_t& a, const bignum_t& b, const bignum_t& c) noexcept -> auto& {
+        auto ctx = context();
+        BN_CTX_start(ctx);
+        auto tmp = BN_CTX_get(ctx);
+        if (tmp && BN_mul(tmp, a.num_, b.num_, ctx))
+            BN_add(num_, tmp, c.num_);
+        BN_CTX_end(ctx);
+        return *this;
+    }
+
+    auto mul(const bignum_t& a, const bignum_t& b) noexcept -> auto& {
+        BN_mul(num_, a.num_, b.num_, context());
+        return *this;
+    }
+
+    auto sqr(const bignum_t& a) noexcept -> auto& {
+        BN_sqr(num_, a.num_, context());
+        return *this;
+    }
+
+    auto mod_add(const bignum_t& a, const bignum_t& b, const bignum_t& m) noexcept -> auto& {
+        BN_mod_add(num_, a.num_, b.num_, m.num_, context());
+        return *this;
+    }
+
+    auto mod_sub(const bignum_t& a, const bignum_t& b, const bignum_t& m) noexcept -> auto& {
+        BN_mod_sub(num_, a.num_, b.num_, m.num_, context());
+        return *this;
+    }
+
+    auto mod_mul(const bignum_t& a, const bignum_t& b, const bignum_t& m) noexcept -> auto& {
+        BN_mod_mul(num_, a.num_, b.num_, m.num_, context());
+        return *this;
+    }
+
+    auto mod_sqr(const bignum_t& a, const bignum_t& m) noexcept -> auto& {
+        BN_mod_sqr(num_, a.num_, m.num_, context());
+        return *this;
+    }
+
+    auto mod_exp(const bignum_t& a, const bignum_t& p, const bignum_t& m) noexcept -> auto& {
+        BN_mod_exp(num_, a.num_, p.num_, m.num_, context());
         return *this;
     }
 
@@ -365,6 +397,20 @@ public:
         BN_clear(num_);
     }
 
+    // one BN_CTX per thread shared by all bignum_t instances
+    static auto context() noexcept -> BN_CTX * {
+        struct pool_t final {
+            BN_CTX *ctx{BN_CTX_new()};
+            ~pool_t() {
+                if (ctx)
+                    BN_CTX_free(ctx);
+            }
+        };
+
+        thread_local pool_t pool;
+        return pool.ctx;
+    }
+
     static auto make_rand(int bits, int top = BN_RAND_TOP_ANY, int bottom = BN_RAND_BOTTOM_ANY) noexcept {
         bignum_t result;
         BN_rand(result.num_, bits, top, bottom);
@@ -373,7 +419,7 @@ public:
 
     static auto make_priv(int bits, int strength, int top = BN_RAND_TOP_ANY, int bottom = BN_RAND_BOTTOM_ANY) noexcept {
         bignum_t result;
-        BN_priv_rand_ex(result.num_, bits, top, bottom, strength, result.ctx_);
+        BN_priv_rand_ex(result.num_, bits, top, bottom, strength, context());
         return result;
     }
 
@@ -386,7 +432,6 @@ private:
     friend auto gcd(const bignum_t& a, const bignum_t& b) noexcept -> bignum_t;
 
     void reset() {
-        ctx_ = BN_CTX_new();
         num_ = BN_new();
     }
 
@@ -405,7 +450,6 @@ private:
         }
     }
 
-    BN_CTX *ctx_{nullptr};
     BIGNUM *num_{nullptr};
 };
 
@@ -430,21 +474,706 @@ inline auto abs(const bignum_t& bn) noexcept -> bignum_t {
 
 inline auto pow(const bignum_t& base, const bignum_t& exp) noexcept -> bignum_t {
     bignum_t result;
-    BN_exp(result.num_, base.num_, exp.num_, base.ctx_);
+    BN_exp(result.num_, base.num_, exp.num_, bignum_t::context());
     return result;
 }
 
 inline auto sqr(const bignum_t& bn) noexcept -> bignum_t {
     bignum_t result;
-    BN_sqr(result.num_, bn.num_, bn.ctx_);
+    BN_sqr(result.num_, bn.num_, bignum_t::context());
     return result;
 }
 
 inline auto gcd(const bignum_t& a, const bignum_t& b) noexcept -> bignum_t {
     bignum_t result;
-    BN_gcd(result.num_, a.num_, b.num_, a.ctx_);
+    BN_gcd(result.num_, a.num_, b.num_, bignum_t::context());
+    return result;
+}
+
+// Modulus with a precomputed montgomery context, for protocols that reuse
+// the same modulus many times. Secret exponents and inverses should use the
+// constant time option. Montgomery needs an odd modulus, so an even modulus
+// falls back to plain modular operations where montgomery form is the value
+// itself, and has no constant time exponent.
+class modulus_t final {
+public:
+    explicit modulus_t(const bignum_t& mod) noexcept : mod_(mod) {
+        if (BN_is_zero(mod_.get()) || BN_is_negative(mod_.get())) return;
+        valid_ = true;
+        if (!BN_is_odd(mod_.get())) return;
+        mont_ = BN_MONT_CTX_new();
+        if (mont_ && !BN_MONT_CTX_set(mont_, mod_.get(), bignum_t::context())) {
+            BN_MONT_CTX_free(mont_);
+            mont_ = nullptr;
+        }
+        valid_ = mont_ != nullptr;
+    }
+
+    modulus_t(const modulus_t& other) noexcept : mod_(other.mod_), valid_(other.valid_) {
+        if (other.mont_)
+            mont_ = BN_MONT_CTX_new();
+        if (mont_ && !BN_MONT_CTX_copy(mont_, other.mont_)) {
+            BN_MONT_CTX_free(mont_);
+            mont_ = nullptr;
+            valid_ = false;
+        }
+    }
+
+    ~modulus_t() {
+        if (mont_)
+            BN_MONT_CTX_free(mont_);
+    }
+
+    auto operator=(const modulus_t&) -> auto& = delete;
+
+    explicit operator bool() const noexcept {
+        return valid_;
+    }
+
+    auto operator!() const noexcept {
+        return !valid_;
+    }
+
+    auto modulus() const noexcept -> const bignum_t& {
+        return mod_;
+    }
+
+    // null for an even modulus
+    auto context() const noexcept -> BN_MONT_CTX * {
+        return mont_;
+    }
+
+    auto mod_exp(bignum_t& out, const bignum_t& base, const bignum_t& exp, bool secret = false) const noexcept -> bignum_t& {
+        if (!valid_) return out;
+        auto ctx = bignum_t::context();
+        if (!mont_)
+            BN_mod_exp(out.get(), base.get(), exp.get(), mod_.get(), ctx);
+        else if (secret)
+            BN_mod_exp_mont_consttime(out.get(), base.get(), exp.get(), mod_.get(), ctx, mont_);
+        else
+            BN_mod_exp_mont(out.get(), base.get(), exp.get(), mod_.get(), ctx, mont_);
+        return out;
+    }
+
+    auto mod_exp(const bignum_t& base, const bignum_t& exp, bool secret = false) const noexcept {
+        bignum_t result;
+        mod_exp(result, base, exp, secret);
+        return result;
+    }
+
+    // one conversion and one montgomery multiply, aR * b / R = ab
+    auto mod_mul(bignum_t& out, const bignum_t& a, const bignum_t& b) const noexcept -> bignum_t& {
+        if (!valid_) return out;
+        auto ctx = bignum_t::context();
+        if (!mont_) {
+            BN_mod_mul(out.get(), a.get(), b.get(), mod_.get(), ctx);
+            return out;
+        }
+        BN_CTX_start(ctx);
+        auto ra = reduce(BN_CTX_get(ctx), a);
+        auto rb = reduce(BN_CTX_get(ctx), b);
+        auto tmp = BN_CTX_get(ctx);
+        if (ra && rb && tmp && BN_to_montgomery(tmp, ra, mont_, ctx))
+            BN_mod_mul_montgomery(out.get(), tmp, rb, mont_, ctx);
+        BN_CTX_end(ctx);
+        return out;
+    }
+
+    auto mod_mul(const bignum_t& a, const bignum_t& b) const noexcept {
+        bignum_t result;
+        mod_mul(result, a, b);
+        return result;
+    }
+
+    auto mod_sqr(bignum_t& out, const bignum_t& a) const noexcept -> bignum_t& {
+        return mod_mul(out, a, a);
+    }
+
+    auto mod_sqr(const bignum_t& a) const noexcept {
+        bignum_t result;
+        mod_mul(result, a, a);
+        return result;
+    }
+
+    auto mod_inverse(const bignum_t& a, bool secret = false) const noexcept {
+        bignum_t result;
+        bignum_t value(a);
+        if (secret)
+            BN_set_flags(value.get(), BN_FLG_CONSTTIME);
+        if (!valid_ || !BN_mod_inverse(result.get(), value.get(), mod_.get(), bignum_t::context()))
+            BN_zero(result.get());
+        return result;
+    }
+
+    // values kept in montgomery form avoid conversion on every multiply
+    auto to_mont(const bignum_t& a) const noexcept {
+        bignum_t result;
+        if (!valid_) return result;
+        auto ctx = bignum_t::context();
+        if (!mont_) {
+            BN_nnmod(result.get(), a.get(), mod_.get(), ctx);
+            return result;
+        }
+        BN_CTX_start(ctx);
+        auto ra = reduce(BN_CTX_get(ctx), a);
+        if (ra)
+            BN_to_montgomery(result.get(), ra, mont_, ctx);
+        BN_CTX_end(ctx);
+        return result;
+    }
+
+    auto from_mont(const bignum_t& a) const noexcept {
+        if (!mont_) return bignum_t(a);
+        bignum_t result;
+        BN_from_montgomery(result.get(), a.get(), mont_, bignum_t::context());
+        return result;
+    }
+
+    auto mont_mul(bignum_t& out, const bignum_t& a, const bignum_t& b) const noexcept -> bignum_t& {
+        if (!valid_) return out;
+        if (!mont_)
+            BN_mod_mul(out.get(), a.get(), b.get(), mod_.get(), bignum_t::context());
+        else
+            BN_mod_mul_montgomery(out.get(), a.get(), b.get(), mont_, bignum_t::context());
+        return out;
+    }
+
+private:
+    bignum_t mod_;
+    BN_MONT_CTX *mont_{nullptr};
+    bool valid_{false};
+
+    auto reduce(BIGNUM *tmp, const bignum_t& a) const noexcept -> const BIGNUM * {
+        if (!tmp) return nullptr;
+        if (!BN_is_negative(a.get()) && BN_ucmp(a.get(), mod_.get()) < 0) return a.get();
+        if (!BN_nnmod(tmp, a.get(), mod_.get(), bignum_t::context())) return nullptr;
+        return tmp;
+    }
+};
+
+// Fixed base exponentiation with precomputed windowed tables, so each
+// exponentiation is bits / window multiplies and no squarings. Table lookups
+// depend on the exponent, so use modulus_t::mod_exp for secret exponents.
+class fixed_base_t final {
+public:
+    fixed_base_t(const modulus_t& mod, const bignum_t& base, std::size_t bits = 0, unsigned window = 4) : mod_(mod), base_(base), bits_(bits ? bits : mod.modulus().bits()), window_(window ? window : 1) {
+        if (!mod_ || window_ > 8) return;
+        const auto width = std::size_t(1) << window_;
+        rows_ = (bits_ + window_ - 1) / window_;
+        table_.resize(rows_ * width);
+        auto row = mod_.to_mont(base_);
+        for (std::size_t pos = 0; pos < rows_; ++pos) {
+            auto entry = &table_[pos * width];
+            entry[0] = mod_.to_mont(bignum_t(1));
+            entry[1] = row;
+            for (std::size_t digit = 2; digit < width; ++digit)
+                mod_.mont_mul(entry[digit], entry[digit - 1], row);
+            mod_.mont_mul(row, entry[width - 1], row);
+        }
+    }
+
+    explicit operator bool() const noexcept {
+        return !table_.empty();
+    }
+
+    auto operator!() const noexcept {
+        return table_.empty();
+    }
+
+    auto exp(const bignum_t& exp) const noexcept {
+        if (table_.empty() || BN_is_negative(exp.get()) || exp.bits() > bits_) return mod_.mod_exp(base_, exp);
+        const auto width = std::size_t(1) << window_;
+        auto result = table_[0];
+        for (std::size_t pos = 0; pos < rows_; ++pos) {
+            unsigned digit = 0;
+            for (unsigned bit = 0; bit < window_; ++bit) {
+                if (BN_is_bit_set(exp.get(), int((pos * window_) + bit)))
+                    digit |= 1U << bit;
+            }
+            if (digit)
+                mod_.mont_mul(result, result, table_[(pos * width) + digit]);
+        }
+        return mod_.from_mont(result);
+    }
+
+    auto size() const noexcept {
+        return table_.size();
+    }
+
+private:
+    modulus_t mod_;
+    bignum_t base_;
+    std::size_t bits_{0};
+    unsigned window_{4};
+    std::size_t rows_{0};
+    std::vector<bignum_t> table_;
+};
+
+// Hybrid integer that keeps values that fit in 128 bits inline, or 64 bits
+// where the compiler has no __int128, and only promotes to a bignum_t when an
+// operation overflows. Results demote back when they fit again. Hashes the
+// same as an equal bignum_t, and offers the bignum_t helpers so either can be
+// used in the same code.
+class number_t final {
+public:
+#ifdef __SIZEOF_INT128__
+    __extension__ using small_t = __int128;
+    __extension__ using wide_t = unsigned __int128;
+#else
+    using small_t = int64_t;
+    using wide_t = uint64_t;
+#endif
+
+    static constexpr small_t small_max = small_t(wide_t(~wide_t(0)) >> 1);
+    static constexpr small_t small_min = -small_max - 1;
+
+    number_t() noexcept = default;
+
+    explicit number_t(small_t value) noexcept : small_(value) {}
+
+    // cppcheck-suppress noExplicitConstructor
+    number_t(const bignum_t& big) {
+        assign(big);
+    }
+
+    // cppcheck-suppress noExplicitConstructor
+    number_t(const std::string& text) {
+        int64_t value{0};
+        auto first = text.data(), last = text.data() + text.size();
+        auto [ptr, ec] = std::from_chars(first, last, value);
+        small_ = value;
+        if (ec == std::errc() && ptr == last) return;
+        small_ = 0;
+        assign(bignum_t(text));
+    }
+
+    number_t(const number_t& other) : small_(other.small_) {
+        if (other.big_)
+            big_ = std::make_unique<bignum_t>(*other.big_);
+    }
+
+    number_t(number_t&& other) noexcept = default;
+    ~number_t() = default;
+
+    auto operator=(const number_t& other) -> auto& {
+        if (this == &other) return *this;
+        small_ = other.small_;
+        if (other.big_)
+            big_ = std::make_unique<bignum_t>(*other.big_);
+        else
+            big_.reset();
+        return *this;
+    }
+
+    auto operator=(number_t&& other) noexcept -> number_t& = default;
+
+    auto operator=(long value) noexcept -> auto& {
+        big_.reset();
+        small_ = value;
+        return *this;
+    }
+
+    operator bignum_t() const {
+        return to_bignum();
+    }
+
+    operator std::string() const {
+        return to_string();
+    }
+
+    explicit operator bool() const noexcept {
+        return big_ ? static_cast<bool>(*big_) : small_ != 0;
+    }
+
+    auto operator!() const noexcept {
+        return big_ ? !*big_ : small_ == 0;
+    }
+
+    auto operator*() const {
+        return to_string();
+    }
+
+    auto operator-() const {
+        if (!big_ && small_ != small_min) return number_t(-small_);
+        return number_t(-to_bignum());
+    }
+
+    auto operator++() -> number_t& {
+        return *this += 1;
+    }
+
+    auto operator--() -> number_t& {
+        return *this -= 1;
+    }
+
+    auto operator+(const number_t& other) const {
+        small_t result{0};
+        if (!big_ && !other.big_ && !add_overflow(small_, other.small_, result)) return number_t(result);
+        return number_t(to_bignum() + other.to_bignum());
+    }
+
+    auto operator-(const number_t& other) const {
+        small_t result{0};
+        if (!big_ && !other.big_ && !sub_overflow(small_, other.small_, result)) return number_t(result);
+        return number_t(to_bignum() - other.to_bignum());
+    }
+
+    auto operator*(const number_t& other) const {
+        small_t result{0};
+        if (!big_ && !other.big_ && !mul_overflow(small_, other.small_, result)) return number_t(result);
+        return number_t(to_bignum() * other.to_bignum());
+    }
+
+    auto operator/(const number_t& other) const {
+        if (!big_ && !other.big_) {
+            if (!other.small_) return number_t();
+            if (small_ != small_min || other.small_ != -1) return number_t(small_ / other.small_);
+        }
+        return number_t(to_bignum() / other.to_bignum());
+    }
+
+    auto operator%(const number_t& other) const {
+        if (!big_ && !other.big_) {
+            if (!other.small_) return number_t();
+            if (other.small_ == -1) return number_t();
+            return number_t(small_ % other.small_);
+        }
+        return number_t(to_bignum() % other.to_bignum());
+    }
+
+    auto operator+(long value) const {
+        return *this + number_t(value);
+    }
+
+    auto operator-(long value) const {
+        return *this - number_t(value);
+    }
+
+    auto operator*(long value) const {
+        return *this * number_t(value);
+    }
+
+    auto operator/(long value) const {
+        return *this / number_t(value);
+    }
+
+    auto operator%(long value) const {
+        return *this % number_t(value);
+    }
+
+    auto operator+=(const number_t& other) -> number_t& {
+        small_t result{0};
+        if (big_ || other.big_ || add_overflow(small_, other.small_, result)) return *this = *this + other;
+        small_ = result;
+        return *this;
+    }
+
+    auto operator-=(const number_t& other) -> number_t& {
+        small_t result{0};
+        if (big_ || other.big_ || sub_overflow(small_, other.small_, result)) return *this = *this - other;
+        small_ = result;
+        return *this;
+    }
+
+    auto operator*=(const number_t& other) -> number_t& {
+        small_t result{0};
+        if (big_ || other.big_ || mul_overflow(small_, other.small_, result)) return *this = *this * other;
+        small_ = result;
+        return *this;
+    }
+
+    auto operator/=(const number_t& other) -> number_t& {
+        return *this = *this / other;
+    }
+
+    auto operator%=(const number_t& other) -> number_t& {
+        return *this = *this % other;
+    }
+
+    auto operator+=(long value) -> number_t& {
+        return *this += number_t(value);
+    }
+
+    auto operator-=(long value) -> number_t& {
+        return *this -= number_t(value);
+    }
+
+    auto operator*=(long value) -> number_t& {
+        return *this *= number_t(value);
+    }
+
+    auto operator==(const number_t& other) const {
+        return compare(other) == 0;
+    }
+
+    auto operator!=(const number_t& other) const {
+        return compare(other) != 0;
+    }
+
+    auto operator<(const number_t& other) const {
+        return compare(other) < 0;
+    }
+
+    auto operator>(const number_t& other) const {
+        return compare(other) > 0;
+    }
+
+    auto operator<=(const number_t& other) const {
+        return compare(other) <= 0;
+    }
+
+    auto operator>=(const number_t& other) const {
+        return compare(other) >= 0;
+    }
+
+    // fused operations like bignum_t, inline while operands stay small
+    auto mul_add(const number_t& a, const number_t& b, const number_t& c) -> number_t& {
+        small_t result{0};
+        if (!a.big_ && !b.big_ && !c.big_ && !mul_overflow(a.small_, b.small_, result) && !add_overflow(result, c.small_, result)) return *this = number_t(result);
+        return *this = a * b + c;
+    }
+
+    auto mul(const number_t& a, const number_t& b) -> number_t& {
+        return *this = a * b;
+    }
+
+    auto sqr(const number_t& a) -> number_t& {
+        return *this = a * a;
+    }
+
+    auto mod_add(const number_t& a, const number_t& b, const number_t& m) -> number_t& {
+        wide_t x{0}, y{0}, mod{0};
+        if (!reduce(a, b, m, x, y, mod)) return big_mod(a, b, m, &bignum_t::mod_add);
+        return *this = number_t(small_t(x >= mod - y ? x - (mod - y) : x + y));
+    }
+
+    auto mod_sub(const number_t& a, const number_t& b, const number_t& m) -> number_t& {
+        wide_t x{0}, y{0}, mod{0};
+        if (!reduce(a, b, m, x, y, mod)) return big_mod(a, b, m, &bignum_t::mod_sub);
+        return *this = number_t(small_t(x >= y ? x - y : x + (mod - y)));
+    }
+
+    auto mod_mul(const number_t& a, const number_t& b, const number_t& m) -> number_t& {
+        wide_t x{0}, y{0}, mod{0};
+        if (!reduce(a, b, m, x, y, mod) || !half_width(mod)) return big_mod(a, b, m, &bignum_t::mod_mul);
+        return *this = number_t(small_t((x * y) % mod));
+    }
+
+    auto mod_sqr(const number_t& a, const number_t& m) -> number_t& {
+        return mod_mul(a, a, m);
+    }
+
+    auto mod_exp(const number_t& a, const number_t& p, const number_t& m) -> number_t& {
+        wide_t x{0}, exp{0}, mod{0};
+        if (p.big_ || p.small_ < 0 || !reduce(a, p, m, x, exp, mod) || !half_width(mod)) return big_mod(a, p, m, &bignum_t::mod_exp);
+        exp = wide_t(p.small_);
+        wide_t result = 1 % mod;
+        while (exp) {
+            if (exp & 1)
+                result = (result * x) % mod;
+            x = (x * x) % mod;
+            exp >>= 1;
+        }
+        return *this = number_t(small_t(result));
+    }
+
+    auto is_small() const noexcept {
+        return !big_;
+    }
+
+    auto is_negative() const noexcept {
+        return big_ ? BN_is_negative(big_->get()) != 0 : small_ < 0;
+    }
+
+    auto value() const noexcept {
+        return small_;
+    }
+
+    auto size() const noexcept -> std::size_t {
+        if (big_) return big_->size();
+        return (bits() + 7) / 8;
+    }
+
+    auto bits() const noexcept -> std::size_t {
+        if (big_) return big_->bits();
+        auto mag = magnitude();
+        std::size_t count = 0;
+        while (mag) {
+            ++count;
+            mag >>= 1;
+        }
+        return count;
+    }
+
+    // big endian magnitude like bignum_t::put
+    auto put(uint8_t *out, std::size_t max) const noexcept {
+        if (big_) return big_->put(out, max);
+        const auto used = size();
+        if (max < used) return std::size_t(0);
+        auto mag = magnitude();
+        for (std::size_t pos = used; pos > 0; --pos) {
+            out[pos - 1] = uint8_t(mag & 0xff);
+            mag >>= 8;
+        }
+        for (auto pos = used; pos < max; ++pos)
+            out[pos] = 0;
+        return used;
+    }
+
+    auto to_bignum() const -> bignum_t {
+        if (big_) return *big_;
+        uint8_t data[sizeof(small_t)];
+        const auto used = put(data, sizeof(data));
+        bignum_t result;
+        BN_bin2bn(data, int(used), result.get());
+        if (small_ < 0)
+            BN_set_negative(result.get(), 1);
+        return result;
+    }
+
+    auto to_string() const -> std::string {
+        if (big_) return big_->to_string();
+        char text[48];
+        auto pos = sizeof(text);
+        auto mag = magnitude();
+        do {
+            text[--pos] = char('0' + int(mag % 10));
+            mag /= 10;
+        } while (mag);
+        if (small_ < 0)
+            text[--pos] = '-';
+        return {text + pos, sizeof(text) - pos};
+    }
+
+private:
+    friend auto btol(const number_t& num) noexcept -> long;
+
+    small_t small_{0};
+    std::unique_ptr<bignum_t> big_;
+
+    auto magnitude() const noexcept -> wide_t {
+        return small_ < 0 ? wide_t(0) - wide_t(small_) : wide_t(small_);
+    }
+
+    void assign(const bignum_t& big) {
+        auto num = big.get();
+        if (BN_num_bits(num) < int(sizeof(small_t) * 8)) {
+            uint8_t data[sizeof(small_t)];
+            BN_bn2binpad(num, data, int(sizeof(data)));
+            wide_t mag{0};
+            for (const auto byte : data)
+                mag = (mag << 8) | byte;
+            big_.reset();
+            small_ = BN_is_negative(num) ? -small_t(mag) : small_t(mag);
+            return;
+        }
+        small_ = 0;
+        big_ = std::make_unique<bignum_t>(big);
+    }
+
+    auto compare(const number_t& other) const -> int {
+        if (!big_ && !other.big_) return (small_ < other.small_) ? -1 : (small_ > other.small_ ? 1 : 0);
+        return BN_cmp(to_bignum().get(), other.to_bignum().get());
+    }
+
+    // small operands reduced into [0, m) for a small positive modulus
+    static auto reduce(const number_t& a, const number_t& b, const number_t& m, wide_t& x, wide_t& y, wide_t& mod) noexcept -> bool {
+        if (a.big_ || b.big_ || m.big_ || m.small_ <= 0) return false;
+        mod = wide_t(m.small_);
+        x = wide_t(a.small_ < 0 ? (m.small_ - 1) - ((-(a.small_ + 1)) % m.small_) : a.small_ % m.small_);
+        y = wide_t(b.small_ < 0 ? (m.small_ - 1) - ((-(b.small_ + 1)) % m.small_) : b.small_ % m.small_);
+        return true;
+    }
+
+    // products of residues only fit when the modulus is half width
+    static auto half_width(wide_t mod) noexcept -> bool {
+        return (mod >> (sizeof(small_t) * 4)) == 0;
+    }
+
+    auto big_mod(const number_t& a, const number_t& b, const number_t& m, bignum_t& (bignum_t::*func)(const bignum_t&, const bignum_t&, const bignum_t&) noexcept) -> number_t& {
+        bignum_t result;
+        (result.*func)(a.to_bignum(), b.to_bignum(), m.to_bignum());
+        return *this = number_t(result);
+    }
+
+    static auto add_overflow(small_t a, small_t b, small_t& out) noexcept -> bool {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_add_overflow(a, b, &out);
+#else
+        if ((b > 0 && a > small_max - b) || (b < 0 && a < small_min - b)) return true;
+        out = a + b;
+        return false;
+#endif
+    }
+
+    static auto sub_overflow(small_t a, small_t b, small_t& out) noexcept -> bool {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_sub_overflow(a, b, &out);
+#else
+        if ((b < 0 && a > small_max + b) || (b > 0 && a < small_min + b)) return true;
+        out = a - b;
+        return false;
+#endif
+    }
+
+    static auto mul_overflow(small_t a, small_t b, small_t& out) noexcept -> bool {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_mul_overflow(a, b, &out);
+#else
+        if (a && b) {
+            const auto result = a * b;
+            if ((a == -1 && b == small_min) || (b == -1 && a == small_min) || result / b != a) return true;
+        }
+        out = a * b;
+        return false;
+#endif
+    }
+};
+
+inline auto btol(const number_t& num) noexcept -> long {
+    if (num.big_) return btol(*num.big_);
+    return static_cast<long>(num.small_);
+}
+
+inline auto btoi(const number_t& num) noexcept -> int {
+    return static_cast<int>(btol(num));
+}
+
+inline auto abs(const number_t& num) -> number_t {
+    return num.is_negative() ? -num : num;
+}
+
+inline auto sqr(const number_t& num) -> number_t {
+    return num * num;
+}
+
+// square and multiply while it fits, else the bignum_t result
+inline auto pow(const number_t& base, const number_t& exp) -> number_t {
+    if (!base.is_small() || !exp.is_small() || exp.is_negative()) return number_t(pow(base.to_bignum(), exp.to_bignum()));
+    auto count = exp.value();
+    number_t result(1L), square(base);
+    while (count) {
+        if (count & 1)
+            result *= square;
+        count >>= 1;
+        if (count)
+            square *= square;
+        if (!result.is_small() || !square.is_small()) return number_t(pow(base.to_bignum(), exp.to_bignum()));
+    }
     return result;
 }
+
+inline auto gcd(const number_t& a, const number_t& b) -> number_t {
+    if (!a.is_small() || !b.is_small() || a.value() == number_t::small_min || b.value() == number_t::small_min) return number_t(gcd(a.to_bignum(), b.to_bignum()));
+    auto x = a.value() < 0 ? -a.value() : a.value();
+    auto y = b.value() < 0 ? -b.value() : b.value();
+    while (y) {
+        const auto next = x % y;
+        x = y;
+        y = next;
+    }
+    return number_t(x);
+}
 } // namespace tycho::crypto
 
 namespace std {
@@ -461,6 +1190,20 @@ struct hash<tycho::crypto::bignum_t> {
         return result;
     }
 };
+
+template <>
+struct hash<tycho::crypto::number_t> {
+    auto operator()(const tycho::crypto::number_t& num) const {
+        if (!num.is_small()) return hash<tycho::crypto::bignum_t>()(num.to_bignum());
+        uint8_t data[sizeof(tycho::crypto::number_t::small_t)];
+        auto size = num.put(data, sizeof(data));
+        std::size_t result{0U};
+        for (std::size_t pos = 0; pos < size; ++pos) {
+            result = (result * 131) + data[pos];
+        }
+        return result;
+    }
+};
 } // namespace std
 
 inline auto operator<<(std::ostream& out, const tycho::crypto::bignum_t& bn) -> std::ostream& {
@@ -468,4 +1211,9 @@ inline auto operator<<(std::ostream& out, const tycho::crypto::bignum_t& bn) ->
     return out;
 }
 
+inline auto operator<<(std::ostream& out, const tycho::crypto::number_t& num) -> std::ostream& {
+    out << num.to_string();
+    return out;
+}
+
 #endif
@@ -4,19 +4,108 @@
 #ifndef TYCHO_CIPHER_HPP_
 #define TYCHO_CIPHER_HPP_
 
+#include "endian.hpp"
+#include "memory.hpp"
+#include "digest.hpp"
+
 #include <string_view>
 #include <utility>
 #include <stdexcept>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <string>
 #include <cstring>
 #include <cstdint>
+#include <climits>
 #include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/kdf.h>
+#include <openssl/core_names.h>
 
 namespace tycho::crypto {
 using key_t = std::pair<const uint8_t *, std::size_t>;
 
 inline constexpr auto nosalt = key_t{nullptr, 64};
 constexpr auto is_salt(const key_t& key) {
-    return key.second == 64;
+    return key.second == 64 || (key.first && key.second == 8);
+}
+
+enum class kdf_t : uint8_t { bytes = 0, pbkdf2, scrypt, hkdf };
+
+// cost is rounds for bytes and pbkdf2, and N for scrypt
+struct kdf_params final {
+    kdf_t kdf{kdf_t::pbkdf2};
+    const EVP_MD *md{EVP_sha256()};
+    uint64_t cost{600000};
+    uint32_t block{8};
+    uint32_t parallel{1};
+    std::string_view info{};
+};
+
+// fills out with size bytes of key material using an EVP_KDF
+inline auto derive_key(const key_t& phrase, const key_t& salt, uint8_t *out, std::size_t size, const kdf_params& params = {}) noexcept {
+    const char *name{nullptr};
+    switch (params.kdf) {
+    case kdf_t::pbkdf2:
+        name = OSSL_KDF_NAME_PBKDF2;
+        break;
+    case kdf_t::scrypt:
+        name = OSSL_KDF_NAME_SCRYPT;
+        break;
+    case kdf_t::hkdf:
+        name = OSSL_KDF_NAME_HKDF;
+        break;
+    default:
+        return false;
+    }
+    if (params.kdf == kdf_t::pbkdf2 && params.cost > UINT_MAX) return false;
+
+    auto kdf = EVP_KDF_fetch(nullptr, name, nullptr);
+    if (!kdf) return false;
+    auto ctx = EVP_KDF_CTX_new(kdf);
+    EVP_KDF_free(kdf);
+    if (!ctx) return false;
+
+    auto salt_size = salt.first ? salt.second : 0;
+    auto pass = const_cast<uint8_t *>(phrase.first);
+    auto salt_data = const_cast<uint8_t *>(salt.first);
+    auto digest = const_cast<char *>(EVP_MD_get0_name(params.md));
+    auto rounds = unsigned(params.cost);
+    auto cost = params.cost;
+    auto block = params.block, parallel = params.parallel;
+    OSSL_PARAM list[6], *pos = list;
+    switch (params.kdf) {
+    case kdf_t::pbkdf2:
+        *pos++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_PASSWORD, pass, phrase.second);
+        *pos++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SALT, salt_data, salt_size);
+        *pos++ = OSSL_PARAM_construct_uint(OSSL_KDF_PARAM_ITER, &rounds);
+        *pos++ = OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, digest, 0);
+        break;
+    case kdf_t::scrypt:
+        *pos++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_PASSWORD, pass, phrase.second);
+        *pos++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SALT, salt_data, salt_size);
+        *pos++ = OSSL_PARAM_construct_uint64(OSSL_KDF_PARAM_SCRYPT_N, &cost);
+        *pos++ = OSSL_PARAM_construct_uint32(OSSL_KDF_PARAM_SCRYPT_R, &block);
+        *pos++ = OSSL_PARAM_construct_uint32(OSSL_KDF_PARAM_SCRYPT_P, &parallel);
+        break;
+    default:
+        *pos++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_KEY, pass, phrase.second);
+        *pos++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SALT, salt_data, salt_size);
+        *pos++ = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_INFO, const_cast<char *>(params.info.data()), params.info.size());
+        *pos++ = OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, digest, 0);
+        break;
+    }
+    *pos = OSSL_PARAM_construct_end();
+    auto result = EVP_KDF_derive(ctx, out, size, list) == 1;
+    EVP_KDF_CTX_free(ctx);
+    return result;
+}
+
+inline auto derive_key(const std::string_view& phrase, const key_t& salt, uint8_t *out, std::size_t size, const kdf_params& params = {}) noexcept {
+    return derive_key(key_t(reinterpret_cast<const uint8_t *>(phrase.data()), phrase.size()), salt, out, size, params);
 }
 
 class keyphrase_t final {
@@ -50,6 +139,10 @@ public:
             size_ = ks;
     }
 
+    keyphrase_t(const std::string_view& phrase, const key_t salt, const EVP_CIPHER *algo, const kdf_params& kdf) noexcept : cipher_(algo) {
+        set(phrase, salt, algo, kdf);
+    }
+
     keyphrase_t(const keyphrase_t& other) noexcept : cipher_(other.cipher_), size_(other.size_) {
         if (size_) {
             memcpy(data_, other.data_, size_);
@@ -59,6 +152,7 @@ public:
 
     ~keyphrase_t() {
         memset(data_, 0, sizeof(data_));
+        memset(iv_, 0, sizeof(iv_));
     }
 
     operator key_t() const {
@@ -117,6 +211,27 @@ public:
             size_ = ks;
     }
 
+    void set(const std::string_view& phrase, const key_t salt, const EVP_CIPHER *algo, const kdf_params& kdf) noexcept {
+        cipher_ = algo;
+        size_ = 0;
+        if (kdf.kdf == kdf_t::bytes) {
+            if (kdf.cost <= INT32_MAX)
+                set(phrase, salt, algo, kdf.md, int(kdf.cost));
+            return;
+        }
+
+        const auto ks = std::size_t(EVP_CIPHER_key_length(algo));
+        const auto is = std::size_t(EVP_CIPHER_iv_length(algo));
+        uint8_t material[maxsize * 2];
+        if (ks > maxsize || is > maxsize) return;
+        if (derive_key(phrase, salt, material, ks + is, kdf)) {
+            memcpy(data_, material, ks);
+            memcpy(iv_, material + ks, is);
+            size_ = ks;
+        }
+        memset(material, 0, sizeof(material));
+    }
+
     auto iv() const noexcept -> const uint8_t * {
         return iv_;
     }
@@ -146,6 +261,7 @@ inline auto get_tag_size(const EVP_CIPHER *algo) -> std::size_t {
     if (algo) {
         auto nid = EVP_CIPHER_nid(algo);
         if (nid == NID_aes_128_gcm || nid == NID_aes_192_gcm || nid == NID_aes_256_gcm) return 16;
+        if (nid == NID_chacha20_poly1305) return 16;
     }
     return 0;
 }
@@ -203,15 +319,18 @@ public:
 
     auto operator=(const keyphrase_t& key) -> decrypt_t& {
         if (key.cipher() != algo_) throw std::runtime_error("cipher type mismatch");
-        if (ctx_)
-            EVP_CIPHER_CTX_free(ctx_);
-
         if (keysize() != key.size()) {
+            if (ctx_)
+                EVP_CIPHER_CTX_free(ctx_);
             ctx_ = nullptr;
             return *this;
         }
 
-        ctx_ = EVP_CIPHER_CTX_new();
+        // re-use existing context rather than re-allocate
+        if (ctx_)
+            EVP_CIPHER_CTX_reset(ctx_);
+        else
+            ctx_ = EVP_CIPHER_CTX_new();
         if (!ctx_) return *this;
         tag_ = get_tag_size(algo_);
         if (tag_) {
@@ -221,6 +340,7 @@ public:
 
         if (!EVP_DecryptInit_ex(ctx_, tag_ ? nullptr : algo_, nullptr, key.data(), key.iv())) {
             EVP_CIPHER_CTX_free(ctx_);
+            ctx_ = nullptr;
             return *this;
         }
 
@@ -260,6 +380,79 @@ public:
         return std::size_t(used);
     }
 
+    // re-init iv only, keeping expanded key for the next message
+    auto reset(const uint8_t *iv) noexcept {
+        if (!ctx_) return false;
+        return EVP_DecryptInit_ex(ctx_, nullptr, nullptr, nullptr, iv) != 0;
+    }
+
+    // single aead message, context remains usable for the next nonce
+    auto open(const uint8_t *nonce, const uint8_t *aad, std::size_t aad_size, const uint8_t *in, std::size_t size, uint8_t *out, const uint8_t *tag) noexcept {
+        auto used = 0;
+        if (!tag_ || !tag || !reset(nonce)) return false;
+        if (aad_size && !EVP_DecryptUpdate(ctx_, nullptr, &used, aad, int(aad_size))) return false;
+        used = 0;
+        if (size && !EVP_DecryptUpdate(ctx_, out, &used, in, int(size))) return false;
+        if (!EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_AEAD_SET_TAG, int(tag_), const_cast<uint8_t *>(tag))) return false;
+        return EVP_DecryptFinal_ex(ctx_, out + used, &used) != 0;
+    }
+
+    auto aad(const uint8_t *data, std::size_t size) noexcept {
+        auto used = 0;
+        if (!ctx_ || !tag_) return false;
+        return size == 0 || EVP_DecryptUpdate(ctx_, nullptr, &used, data, int(size)) != 0;
+    }
+
+    // list of key_t fragments, authenticated in order without flattening
+    template <typename Fragments>
+    auto aad(const Fragments& list) noexcept {
+        for (const auto& [data, size] : list) {
+            if (!aad(data, size)) return false;
+        }
+        return true;
+    }
+
+    // in-place only for stream and aead ciphers, where output matches input
+    auto update(uint8_t *data, std::size_t size) noexcept {
+        if (!ctx_ || EVP_CIPHER_block_size(algo_) != 1) return std::size_t(0);
+        return update(data, data, size);
+    }
+
+    auto update(bytearray_t& mem) noexcept {
+        if (mem.empty()) return std::size_t(0);
+        return update(mem.data(), mem.size_bytes());
+    }
+
+    // gather key_t fragments thru cipher into contiguous output
+    template <typename Fragments>
+    auto gather(const Fragments& list, uint8_t *out) noexcept {
+        std::size_t total = 0;
+        if (!ctx_) return total;
+        for (const auto& [data, size] : list) {
+            auto used = 0;
+            if (size && !EVP_DecryptUpdate(ctx_, out + total, &used, data, int(size))) return std::size_t(0);
+            total += std::size_t(used);
+        }
+        return total;
+    }
+
+    auto open(const uint8_t *nonce, const uint8_t *aad, std::size_t aad_size, bytearray_t& mem, const uint8_t *tag) noexcept {
+        if (mem.empty()) return open(nonce, aad, aad_size, nullptr, 0, nullptr, tag);
+        return open(nonce, aad, aad_size, mem.data(), mem.size_bytes(), mem.data(), tag);
+    }
+
+    template <typename Fragments>
+    auto open(const uint8_t *nonce, const Fragments& aad_list, const Fragments& in_list, uint8_t *out, const uint8_t *tag) noexcept {
+        auto used = 0;
+        if (!tag_ || !tag || !reset(nonce) || !aad(aad_list)) return false;
+        std::size_t size = 0;
+        for (const auto& frag : in_list)
+            size += frag.second;
+        if (gather(in_list, out) != size) return false;
+        if (!EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_AEAD_SET_TAG, int(tag_), const_cast<uint8_t *>(tag))) return false;
+        return EVP_DecryptFinal_ex(ctx_, out + size, &used) != 0;
+    }
+
     auto finish(uint8_t *out, const uint8_t *tag) noexcept {
         auto used = 0;
 
@@ -312,6 +505,7 @@ public:
 
         if (!EVP_EncryptInit_ex(ctx_, tag_ ? nullptr : algo_, nullptr, key.data(), key.iv())) {
             EVP_CIPHER_CTX_free(ctx_);
+            ctx_ = nullptr;
             return;
         }
         EVP_CIPHER_CTX_set_key_length(ctx_, EVP_MAX_KEY_LENGTH);
@@ -338,15 +532,18 @@ public:
 
     auto operator=(const keyphrase_t& key) -> encrypt_t& {
         if (key.cipher() != algo_) throw std::runtime_error("cipher type mismatch");
-        if (ctx_)
-            EVP_CIPHER_CTX_free(ctx_);
-
         if (keysize() != key.size()) {
+            if (ctx_)
+                EVP_CIPHER_CTX_free(ctx_);
             ctx_ = nullptr;
             return *this;
         }
 
-        ctx_ = EVP_CIPHER_CTX_new();
+        // re-use existing context rather than re-allocate
+        if (ctx_)
+            EVP_CIPHER_CTX_reset(ctx_);
+        else
+            ctx_ = EVP_CIPHER_CTX_new();
         if (!ctx_) return *this;
         tag_ = get_tag_size(algo_);
         if (tag_) {
@@ -356,6 +553,7 @@ public:
 
         if (!EVP_EncryptInit_ex(ctx_, tag_ ? nullptr : algo_, nullptr, key.data(), key.iv())) {
             EVP_CIPHER_CTX_free(ctx_);
+            ctx_ = nullptr;
             return *this;
         }
 
@@ -395,6 +593,79 @@ public:
         return std::size_t(used);
     }
 
+    // re-init iv only, keeping expanded key for the next message
+    auto reset(const uint8_t *iv) noexcept {
+        if (!ctx_) return false;
+        return EVP_EncryptInit_ex(ctx_, nullptr, nullptr, nullptr, iv) != 0;
+    }
+
+    // single aead message, context remains usable for the next nonce
+    auto seal(const uint8_t *nonce, const uint8_t *aad, std::size_t aad_size, const uint8_t *in, std::size_t size, uint8_t *out, uint8_t *tag) noexcept {
+        auto used = 0;
+        if (!tag_ || !tag || !reset(nonce)) return false;
+        if (aad_size && !EVP_EncryptUpdate(ctx_, nullptr, &used, aad, int(aad_size))) return false;
+        used = 0;
+        if (size && !EVP_EncryptUpdate(ctx_, out, &used, in, int(size))) return false;
+        if (!EVP_EncryptFinal_ex(ctx_, out + used, &used)) return false;
+        return EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_AEAD_GET_TAG, int(tag_), tag) != 0;
+    }
+
+    auto aad(const uint8_t *data, std::size_t size) noexcept {
+        auto used = 0;
+        if (!ctx_ || !tag_) return false;
+        return size == 0 || EVP_EncryptUpdate(ctx_, nullptr, &used, data, int(size)) != 0;
+    }
+
+    // list of key_t fragments, authenticated in order without flattening
+    template <typename Fragments>
+    auto aad(const Fragments& list) noexcept {
+        for (const auto& [data, size] : list) {
+            if (!aad(data, size)) return false;
+        }
+        return true;
+    }
+
+    // in-place only for stream and aead ciphers, where output matches input
+    auto update(uint8_t *data, std::size_t size) noexcept {
+        if (!ctx_ || EVP_CIPHER_block_size(algo_) != 1) return std::size_t(0);
+        return update(data, data, size);
+    }
+
+    auto update(bytearray_t& mem) noexcept {
+        if (mem.empty()) return std::size_t(0);
+        return update(mem.data(), mem.size_bytes());
+    }
+
+    // gather key_t fragments thru cipher into contiguous output
+    template <typename Fragments>
+    auto gather(const Fragments& list, uint8_t *out) noexcept {
+        std::size_t total = 0;
+        if (!ctx_) return total;
+        for (const auto& [data, size] : list) {
+            auto used = 0;
+            if (size && !EVP_EncryptUpdate(ctx_, out + total, &used, data, int(size))) return std::size_t(0);
+            total += std::size_t(used);
+        }
+        return total;
+    }
+
+    auto seal(const uint8_t *nonce, const uint8_t *aad, std::size_t aad_size, bytearray_t& mem, uint8_t *tag) noexcept {
+        if (mem.empty()) return seal(nonce, aad, aad_size, nullptr, 0, nullptr, tag);
+        return seal(nonce, aad, aad_size, mem.data(), mem.size_bytes(), mem.data(), tag);
+    }
+
+    template <typename Fragments>
+    auto seal(const uint8_t *nonce, const Fragments& aad_list, const Fragments& in_list, uint8_t *out, uint8_t *tag) noexcept {
+        auto used = 0;
+        if (!tag_ || !tag || !reset(nonce) || !aad(aad_list)) return false;
+        std::size_t size = 0;
+        for (const auto& frag : in_list)
+            size += frag.second;
+        if (gather(in_list, out) != size) return false;
+        if (!EVP_EncryptFinal_ex(ctx_, out + size, &used)) return false;
+        return EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_AEAD_GET_TAG, int(tag_), tag) != 0;
+    }
+
     auto finish(uint8_t *out, uint8_t *tag = nullptr) noexcept {
         auto used = 0;
 
@@ -415,5 +686,415 @@ private:
     const EVP_CIPHER *algo_{nullptr};
     std::size_t tag_{0};
 };
+// Bounded cache of derived keys so re-opening with the same phrase and salt
+// skips an expensive kdf. Entries are looked up by a keyed hash of the phrase,
+// salt, and kdf parameters, and keyphrase_t zeroes key material when evicted.
+class keycache_t final {
+public:
+    explicit keycache_t(std::size_t limit = 32) noexcept : cache_(limit) {}
+    keycache_t(const keycache_t&) = delete;
+    auto operator=(const keycache_t&) -> auto& = delete;
+
+    auto get(const std::string_view& phrase, const key_t salt, const EVP_CIPHER *algo = EVP_aes_256_cbc(), const kdf_params& kdf = {}) {
+        id_t id{};
+        const auto keyed = make_id(id, phrase, salt, algo, kdf);
+        if (keyed) {
+            keyphrase_t key;
+            if (cache_.find(id, [&key](const keyphrase_t& entry) {
+                    key = entry;
+                    return true;
+                })) return key;
+        }
+
+        const keyphrase_t key(phrase, salt, algo, kdf);
+        if (key && keyed)
+            cache_.emplace(id, key);
+        return key;
+    }
+
+    void clear() noexcept {
+        cache_.clear();
+    }
+
+    auto size() const noexcept {
+        return cache_.size();
+    }
+
+    auto hits() const noexcept {
+        return cache_.hits();
+    }
+
+    auto limit() const noexcept {
+        return cache_.limit();
+    }
+
+private:
+    using id_t = keyed_cache<keyphrase_t>::id_t;
+
+    keyed_cache<keyphrase_t> cache_;
+
+    auto make_id(id_t& id, const std::string_view& phrase, const key_t& salt, const EVP_CIPHER *algo, const kdf_params& kdf) const noexcept -> bool {
+        uint8_t params[40]{};
+        params[0] = uint8_t(kdf.kdf);
+        be_set32(params + 1, uint32_t(algo ? EVP_CIPHER_nid(algo) : 0));
+        be_set32(params + 5, uint32_t(kdf.md ? EVP_MD_get_type(kdf.md) : 0));
+        be_set64(params + 9, kdf.cost);
+        be_set32(params + 17, kdf.block);
+        be_set32(params + 21, kdf.parallel);
+        be_set32(params + 25, uint32_t(phrase.size()));
+        be_set32(params + 29, uint32_t(salt.first ? salt.second : 0));
+        be_set32(params + 33, uint32_t(kdf.info.size()));
+
+        auto hash = cache_.hash();
+        hash.update(params, sizeof(params));
+        hash.update(phrase.data(), phrase.size());
+        if (salt.first)
+            hash.update(salt.first, salt.second);
+        hash.update(kdf.info.data(), kdf.info.size());
+        return cache_.make_id(hash, id);
+    }
+};
+
+// Per-message aead nonce sequence, base iv xor a 64 bit counter as in tls 1.3.
+// A sequence must never repeat for a given key, so exhaustion throws.
+class nonce_t final {
+public:
+    static constexpr std::size_t nonce_size = 12;
+
+    nonce_t() noexcept {
+        RAND_bytes(base_, sizeof(base_));
+    }
+
+    explicit nonce_t(const uint8_t *base, uint64_t sequence = 0) noexcept : next_(sequence) {
+        memcpy(base_, base, sizeof(base_));
+    }
+
+    ~nonce_t() {
+        memset(base_, 0, sizeof(base_));
+    }
+
+    auto operator*() const noexcept -> const uint8_t * {
+        return nonce_;
+    }
+
+    auto next() -> const uint8_t * {
+        if (next_ == UINT64_MAX) throw std::overflow_error("nonce sequence exhausted");
+        return at(next_++);
+    }
+
+    // receiver side nonce for an explicit sequence number
+    auto at(uint64_t sequence) noexcept -> const uint8_t * {
+        memcpy(nonce_, base_, sizeof(nonce_));
+        for (std::size_t pos = 0; pos < 8; ++pos)
+            nonce_[nonce_size - 1 - pos] ^= uint8_t(sequence >> (pos * 8));
+        return nonce_;
+    }
+
+    auto base() const noexcept -> const uint8_t * {
+        return base_;
+    }
+
+    auto sequence() const noexcept {
+        return next_;
+    }
+
+private:
+    uint8_t base_[nonce_size]{0};
+    uint8_t nonce_[nonce_size]{0};
+    uint64_t next_{0};
+};
+
+// Chunked aead container. Fixed size segments are sealed independently so
+// they can be processed in parallel or opened by random access. Each segment
+// nonce is the header prefix, segment counter, and a final segment flag, and
+// the header is authenticated with every segment, so reordering, tampering,
+// or truncation fails to open. The key is derived from the passphrase with
+// the pbkdf2 or scrypt cost recorded in the header, and an opened header
+// with a cost past a sane limit is refused. The parallel calls take a
+// task_pool, so callers using them include tasks.hpp.
+class segments_t final {
+public:
+    static constexpr std::size_t header_size = 32;
+    static constexpr std::size_t tag_size = 16;
+    static constexpr std::size_t default_segment = 65536;
+
+    explicit segments_t(const std::string_view& phrase, const EVP_CIPHER *algo = EVP_aes_256_gcm(), std::size_t segment = default_segment, const kdf_params& kdf = {}) : algo_(algo), segment_(segment) {
+        const auto id = cipher_id(algo);
+        if (!id || !segment || segment > max_segment || !is_kdf(kdf)) throw std::runtime_error("invalid segment cipher");
+        memcpy(header_, magic, 4);
+        header_[4] = id;
+        header_[5] = 1; // version
+        header_[6] = uint8_t(kdf.kdf);
+        be_set32(header_ + 8, uint32_t(segment));
+        be_set32(header_ + 12, uint32_t(kdf.cost));
+        RAND_bytes(header_ + 16, 15);
+        key_.set(phrase, key_t(header_ + 16, 8), algo_, kdf);
+        if (!key_) throw std::runtime_error("invalid segment key");
+    }
+
+    // header kdf and cost are untrusted, so both are checked before deriving
+    segments_t(const std::string_view& phrase, const uint8_t *header) {
+        if (!header || memcmp(header, magic, 4) != 0 || header[5] != 1) throw std::runtime_error("invalid segment header");
+        memcpy(header_, header, header_size);
+        algo_ = cipher_algo(header_[4]);
+        segment_ = be_get32(header_ + 8);
+        kdf_params kdf;
+        kdf.kdf = kdf_t(header_[6]);
+        kdf.cost = be_get32(header_ + 12);
+        if (!algo_ || !segment_ || segment_ > max_segment || !is_kdf(kdf)) throw std::runtime_error("invalid segment header");
+        key_.set(phrase, key_t(header_ + 16, 8), algo_, kdf);
+        if (!key_) throw std::runtime_error("invalid segment key");
+    }
+
+    auto header() const noexcept -> const uint8_t * {
+        return header_;
+    }
+
+    auto cipher() const noexcept {
+        return algo_;
+    }
+
+    auto segment_size() const noexcept {
+        return segment_;
+    }
+
+    auto segments(std::size_t size) const noexcept -> std::size_t {
+        return size ? (size + segment_ - 1) / segment_ : 1;
+    }
+
+    auto sealed_size(std::size_t size) const noexcept {
+        return header_size + (segments(size) * tag_size) + size;
+    }
+
+    // offset of a sealed segment from start of container
+    auto offset(uint64_t index) const noexcept -> std::size_t {
+        return header_size + (index * (segment_ + tag_size));
+    }
+
+    // sealed segment is ciphertext followed by tag, size + tag_size bytes
+    auto seal(uint64_t index, const uint8_t *in, std::size_t size, uint8_t *out, bool last = false) const noexcept {
+        const context_t ctx(*this, true);
+        return seal(ctx, index, in, size, out, last);
+    }
+
+    // size is of the sealed segment, so includes tag
+    auto open(uint64_t index, const uint8_t *in, std::size_t size, uint8_t *out, bool last = false) const noexcept {
+        const context_t ctx(*this, false);
+        return open(ctx, index, in, size, out, last);
+    }
+
+    // out must hold sealed_size(size)
+    template <typename Pool>
+    auto encrypt(const uint8_t *in, std::size_t size, uint8_t *out, Pool& pool) const {
+        memcpy(out, header_, header_size);
+        const auto count = segments(size);
+        const auto result = each_segment(pool, count, true, [&](const context_t& ctx, std::size_t index) {
+            const auto from = index * segment_;
+            const auto part = std::min(segment_, size - from);
+            return seal(ctx, index, in + from, part, out + offset(index), index + 1 == count);
+        });
+        if (!result) throw std::runtime_error("segment seal failed");
+        return sealed_size(size);
+    }
+
+    // input includes header, out must hold plain_size(size)
+    template <typename Pool>
+    auto decrypt(const uint8_t *in, std::size_t size, uint8_t *out, Pool& pool) const {
+        const auto plain = plain_size(size);
+        if (memcmp(in, header_, header_size) != 0) throw std::runtime_error("segment header mismatch");
+        const auto count = segments(plain);
+        const auto result = each_segment(pool, count, false, [&](const context_t& ctx, std::size_t index) {
+            const auto from = index * segment_;
+            const auto part = std::min(segment_, plain - from) + tag_size;
+            return open(ctx, index, in + offset(index), part, out + from, index + 1 == count);
+        });
+        if (!result) throw std::runtime_error("segment authentication failed");
+        return plain;
+    }
+
+    auto plain_size(std::size_t sealed) const -> std::size_t {
+        if (sealed < header_size + tag_size) throw std::runtime_error("segment container truncated");
+        const auto body = sealed - header_size;
+        const auto count = (body + segment_ + tag_size - 1) / (segment_ + tag_size);
+        const auto last = body - ((count - 1) * (segment_ + tag_size));
+        if (last < tag_size) throw std::runtime_error("segment container truncated");
+        return body - (count * tag_size);
+    }
+
+    // writes header and sealed segments, batched across the pool
+    template <typename Pool>
+    auto encrypt(std::istream& in, std::ostream& out, Pool& pool) const {
+        const auto batch = std::max(pool.size(), std::size_t(1)) * 4;
+        std::vector<uint8_t> plain(batch * segment_), sealed(batch * (segment_ + tag_size));
+        uint64_t base = 0;
+        out.write(reinterpret_cast<const char *>(header_), header_size);
+        for (;;) {
+            in.read(reinterpret_cast<char *>(plain.data()), std::streamsize(plain.size()));
+            const auto got = std::size_t(in.gcount());
+            const auto last = got < plain.size() || in.peek() == std::char_traits<char>::eof();
+            const auto count = segments(got);
+            const auto result = each_segment(pool, count, true, [&](const context_t& ctx, std::size_t index) {
+                const auto from = index * segment_;
+                const auto part = std::min(segment_, got - from);
+                return seal(ctx, base + index, plain.data() + from, part, sealed.data() + (index * (segment_ + tag_size)), last && index + 1 == count);
+            });
+            if (!result) return false;
+            out.write(reinterpret_cast<const char *>(sealed.data()), std::streamsize(got + (count * tag_size)));
+            if (!out) return false;
+            if (last) return true;
+            base += count;
+        }
+    }
+
+    // input positioned past header this object was created from
+    template <typename Pool>
+    auto decrypt(std::istream& in, std::ostream& out, Pool& pool) const {
+        const auto batch = std::max(pool.size(), std::size_t(1)) * 4;
+        std::vector<uint8_t> sealed(batch * (segment_ + tag_size)), plain(batch * segment_);
+        uint64_t base = 0;
+        for (;;) {
+            in.read(reinterpret_cast<char *>(sealed.data()), std::streamsize(sealed.size()));
+            const auto got = std::size_t(in.gcount());
+            const auto last = got < sealed.size() || in.peek() == std::char_traits<char>::eof();
+            const auto count = (got + segment_ + tag_size - 1) / (segment_ + tag_size);
+            if (!count || got - ((count - 1) * (segment_ + tag_size)) < tag_size) return false;
+            const auto result = each_segment(pool, count, false, [&](const context_t& ctx, std::size_t index) {
+                const auto from = index * (segment_ + tag_size);
+                const auto part = std::min(segment_ + tag_size, got - from);
+                return open(ctx, base + index, sealed.data() + from, part, plain.data() + (index * segment_), last && index + 1 == count);
+            });
+            if (!result) return false;
+            out.write(reinterpret_cast<const char *>(plain.data()), std::streamsize(got - (count * tag_size)));
+            if (!out) return false;
+            if (last) return true;
+            base += count;
+        }
+    }
+
+private:
+    static constexpr std::size_t max_segment = 16777216;
+    static constexpr uint64_t max_rounds = 10000000;
+    static constexpr uint64_t max_scrypt = 1048576;
+    static constexpr uint8_t magic[4] = {'T', 'S', 'C', 'S'};
+
+    const EVP_CIPHER *algo_{nullptr};
+    std::size_t segment_{default_segment};
+    keyphrase_t key_;
+    uint8_t header_[header_size]{0};
+
+    // password kdfs the header can record, sha256 with scrypt r=8 and p=1
+    static auto is_kdf(const kdf_params& kdf) noexcept -> bool {
+        if (!kdf.md || EVP_MD_get_type(kdf.md) != NID_sha256) return false;
+        switch (kdf.kdf) {
+        case kdf_t::pbkdf2:
+            return kdf.cost && kdf.cost <= max_rounds;
+        case kdf_t::scrypt:
+            return kdf.cost > 1 && kdf.cost <= max_scrypt && !(kdf.cost & (kdf.cost - 1)) && kdf.block == 8 && kdf.parallel == 1;
+        default:
+            return false;
+        }
+    }
+
+    static auto cipher_id(const EVP_CIPHER *algo) noexcept -> uint8_t {
+        if (!algo) return 0;
+        switch (EVP_CIPHER_nid(algo)) {
+        case NID_aes_256_gcm:
+            return 1;
+        case NID_chacha20_poly1305:
+            return 2;
+        case NID_aes_128_gcm:
+            return 3;
+        default:
+            return 0;
+        }
+    }
+
+    static auto cipher_algo(uint8_t id) noexcept -> const EVP_CIPHER * {
+        switch (id) {
+        case 1:
+            return EVP_aes_256_gcm();
+        case 2:
+            return EVP_chacha20_poly1305();
+        case 3:
+            return EVP_aes_128_gcm();
+        default:
+            return nullptr;
+        }
+    }
+
+    // Keyed once, so each segment only sets a new iv; the key schedule is
+    // done per worker rather than per segment.
+    class context_t final {
+    public:
+        context_t(const segments_t& from, bool encrypt) noexcept : ctx_(EVP_CIPHER_CTX_new()), mode_(encrypt ? 1 : 0) {
+            if (ctx_ && !(EVP_CipherInit_ex(ctx_, from.algo_, nullptr, nullptr, nullptr, mode_) && EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_AEAD_SET_IVLEN, 12, nullptr) && EVP_CipherInit_ex(ctx_, nullptr, nullptr, from.key_.data(), nullptr, mode_))) {
+                EVP_CIPHER_CTX_free(ctx_);
+                ctx_ = nullptr;
+            }
+        }
+
+        context_t(const context_t&) = delete;
+        auto operator=(const context_t&) -> auto& = delete;
+
+        ~context_t() {
+            if (ctx_)
+                EVP_CIPHER_CTX_free(ctx_);
+        }
+
+        auto get() const noexcept {
+            return ctx_;
+        }
+
+        auto mode() const noexcept {
+            return mode_;
+        }
+
+    private:
+        EVP_CIPHER_CTX *ctx_{nullptr};
+        int mode_{0};
+    };
+
+    // one context per worker, each taking every jobs'th segment
+    template <typename Pool, typename Func>
+    auto each_segment(Pool& pool, std::size_t count, bool encrypt, Func func) const {
+        const auto jobs = std::min(count, std::max(pool.size(), std::size_t(1)));
+        return parallel_for(pool, jobs, [&](std::size_t job) {
+            const context_t ctx(*this, encrypt);
+            for (auto index = job; index < count; index += jobs) {
+                if (!func(ctx, index)) return false;
+            }
+            return true;
+        });
+    }
+
+    auto start(const context_t& ctx, uint64_t index, bool last) const noexcept -> bool {
+        uint8_t iv[12];
+        memcpy(iv, header_ + 24, 7);
+        be_set32(iv + 7, uint32_t(index));
+        iv[11] = last ? 1 : 0;
+
+        auto used = 0;
+        return ctx.get() && EVP_CipherInit_ex(ctx.get(), nullptr, nullptr, nullptr, iv, ctx.mode()) && EVP_CipherUpdate(ctx.get(), nullptr, &used, header_, int(header_size));
+    }
+
+    auto seal(const context_t& ctx, uint64_t index, const uint8_t *in, std::size_t size, uint8_t *out, bool last) const noexcept -> bool {
+        if (size > segment_ || index > UINT32_MAX || !start(ctx, index, last)) return false;
+        auto used = 0;
+        auto result = size == 0 || EVP_EncryptUpdate(ctx.get(), out, &used, in, int(size));
+        if (result)
+            result = EVP_EncryptFinal_ex(ctx.get(), out + used, &used) && EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_GET_TAG, int(tag_size), out + size);
+        return result != 0;
+    }
+
+    auto open(const context_t& ctx, uint64_t index, const uint8_t *in, std::size_t size, uint8_t *out, bool last) const noexcept -> bool {
+        if (size < tag_size || size > segment_ + tag_size || index > UINT32_MAX || !start(ctx, index, last)) return false;
+        size -= tag_size;
+        auto used = 0;
+        auto result = size == 0 || EVP_DecryptUpdate(ctx.get(), out, &used, in, int(size));
+        if (result)
+            result = EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_SET_TAG, int(tag_size), const_cast<uint8_t *>(in + size)) && EVP_DecryptFinal_ex(ctx.get(), out + used, &used);
+        return result != 0;
+    }
+};
 } // namespace tycho::crypto
 #endif
@@ -4,12 +4,23 @@
 #ifndef TYCHO_DIGEST_HPP_
 #define TYCHO_DIGEST_HPP_
 
+#include "encoding.hpp"
+
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <tuple>
+#include <array>
+#include <list>
+#include <map>
+#include <mutex>
 #include <cstring>
 #include <cstddef>
+#include <ostream>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
 
 namespace tycho::crypto {
 class digest_t final {
@@ -97,6 +108,15 @@ public:
         return reinterpret_cast<const char *>(data_);
     }
 
+    auto to_hex(bool upper = false) const {
+        return tycho::to_hex(data_, size_, upper);
+    }
+
+    // hex into a caller buffer of at least size() * 2 characters
+    auto to_hex(char *out, bool upper = false) const noexcept {
+        return tycho::hex_encode(data_, size_, out, upper);
+    }
+
     auto update(const char *cp, std::size_t size) noexcept {
         return !ctx_ || size_ ? false : EVP_DigestUpdate(ctx_, reinterpret_cast<uint8_t *>(const_cast<char *>(cp)), size) == 1;
     }
@@ -190,5 +210,128 @@ inline auto digest_id(const char *name) {
 inline auto digest_name(const EVP_MD *md = EVP_sha256()) {
     return EVP_MD_get0_name(md);
 }
+
+// Bounded lru cache of secret values such as derived keys. Entries are found
+// by an hmac-sha256 id under a random secret made for each cache, so an id
+// says nothing about the passphrase or key material it was built from. The
+// stored type should zero itself when destroyed.
+template <typename T>
+class keyed_cache final {
+public:
+    using id_t = std::array<uint8_t, 32>;
+
+    explicit keyed_cache(std::size_t limit) noexcept : limit_(limit ? limit : 1) {
+        uint8_t secret[64]{}, pad[64]{};
+        keyed_ = RAND_bytes(secret, 32) == 1;
+        for (std::size_t pos = 0; pos < sizeof(pad); ++pos)
+            pad[pos] = secret[pos] ^ 0x36;
+        inner_.update(pad, sizeof(pad));
+        for (std::size_t pos = 0; pos < sizeof(pad); ++pos)
+            pad[pos] = secret[pos] ^ 0x5c;
+        outer_.update(pad, sizeof(pad));
+        OPENSSL_cleanse(secret, sizeof(secret));
+        OPENSSL_cleanse(pad, sizeof(pad));
+    }
+
+    keyed_cache(const keyed_cache&) = delete;
+    auto operator=(const keyed_cache&) -> auto& = delete;
+
+    // keyed hash to feed id inputs into, then completed by make_id()
+    auto hash() const noexcept {
+        return inner_;
+    }
+
+    auto make_id(digest_t& hash, id_t& id) const noexcept -> bool {
+        if (!keyed_ || !hash.finish()) return false;
+        auto outer = outer_;
+        if (!outer.update(hash.data(), hash.size()) || !outer.finish()) return false;
+        memcpy(id.data(), outer.data(), id.size()); // FLawFinder: ignore
+        return true;
+    }
+
+    // visit a cached entry, which is dropped if func returns false
+    template <typename Func>
+    auto find(const id_t& id, Func func) -> bool {
+        const std::lock_guard lock(lock_);
+        auto it = index_.find(id);
+        if (it == index_.end()) return false;
+        auto entry = it->second;
+        if (!func(entry->second)) {
+            index_.erase(it);
+            keys_.erase(entry);
+            return false;
+        }
+        keys_.splice(keys_.begin(), keys_, entry);
+        ++hits_;
+        return true;
+    }
+
+    // the first entry stored for an id is kept, the oldest past limit dropped
+    template <typename... Args>
+    void emplace(const id_t& id, Args&&...args) {
+        const std::lock_guard lock(lock_);
+        if (index_.find(id) != index_.end()) return;
+        keys_.emplace_front(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(std::forward<Args>(args)...));
+        index_[id] = keys_.begin();
+        if (keys_.size() > limit_) {
+            index_.erase(keys_.back().first);
+            keys_.pop_back();
+        }
+    }
+
+    template <typename Pred>
+    auto erase_if(Pred pred) {
+        const std::lock_guard lock(lock_);
+        std::size_t count = 0;
+        for (auto it = keys_.begin(); it != keys_.end();) {
+            if (!pred(it->second)) {
+                ++it;
+                continue;
+            }
+            index_.erase(it->first);
+            it = keys_.erase(it);
+            ++count;
+        }
+        return count;
+    }
+
+    void clear() noexcept {
+        const std::lock_guard lock(lock_);
+        index_.clear();
+        keys_.clear();
+    }
+
+    auto size() const noexcept {
+        const std::lock_guard lock(lock_);
+        return keys_.size();
+    }
+
+    auto hits() const noexcept {
+        const std::lock_guard lock(lock_);
+        return hits_;
+    }
+
+    auto limit() const noexcept {
+        return limit_;
+    }
+
+private:
+    using list_t = std::list<std::pair<id_t, T>>;
+
+    std::size_t limit_{1};
+    std::size_t hits_{0};
+    bool keyed_{false};
+    digest_t inner_{EVP_sha256()};
+    digest_t outer_{EVP_sha256()};
+    list_t keys_;
+    std::map<id_t, typename list_t::iterator> index_;
+    mutable std::mutex lock_;
+};
 } // namespace tycho::crypto
+
+inline auto operator<<(std::ostream& out, const tycho::crypto::digest_t& digest) -> std::ostream& {
+    char hex[EVP_MAX_MD_SIZE * 2];
+    out.write(hex, std::streamsize(digest.to_hex(hex)));
+    return out;
+}
 #endif
@@ -4,8 +4,13 @@
 #ifndef TYCHO_ECKEY_HPP_
 #define TYCHO_ECKEY_HPP_
 
+#include "digest.hpp"
+#include "endian.hpp"
+
 #include <utility>
 #include <string>
+#include <chrono>
+#include <array>
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
@@ -15,6 +20,7 @@
 #include <openssl/kdf.h>
 #include <openssl/bio.h>
 #include <openssl/pem.h>
+#include <openssl/x509.h>
 #include <openssl/ecdsa.h>
 #include <openssl/obj_mac.h>
 #include <openssl/core_names.h>
@@ -22,6 +28,147 @@
 namespace tycho::crypto {
 using key_t = std::pair<const uint8_t *, std::size_t>;
 
+// key agreement with peer, expanded thru hkdf, returns size derived or 0
+inline auto derive_shared(EVP_PKEY *key, EVP_PKEY *peer, std::string_view info, uint8_t *out, std::size_t max, std::size_t keysize = 0, key_t salt = key_t{nullptr, 0}, const EVP_MD *md = EVP_sha256()) noexcept -> std::size_t {
+    if (!key || !peer || !md || keysize > max) return 0;
+    auto ctx = EVP_PKEY_CTX_new(key, nullptr);
+    if (!ctx) return 0;
+    std::size_t size = 0;
+    if (!keysize)
+        keysize = EVP_MD_get_size(md);
+    EVP_PKEY_derive_init(ctx);
+    if ((EVP_PKEY_derive_set_peer(ctx, peer) <= 0) || (EVP_PKEY_derive(ctx, nullptr, &size) <= 0) || (size < 1)) {
+        EVP_PKEY_CTX_free(ctx);
+        return 0;
+    }
+    auto secret = std::make_unique<uint8_t[]>(size);
+    const auto agreed = EVP_PKEY_derive(ctx, &secret[0], &size) > 0;
+    EVP_PKEY_CTX_free(ctx);
+
+    ctx = agreed ? EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr) : nullptr;
+    if (!ctx) {
+        OPENSSL_cleanse(&secret[0], size);
+        return 0;
+    }
+    EVP_PKEY_derive_init(ctx);
+    EVP_PKEY_CTX_hkdf_mode(ctx, EVP_PKEY_HKDEF_MODE_EXTRACT_AND_EXPAND);
+    EVP_PKEY_CTX_set_hkdf_md(ctx, md);
+    EVP_PKEY_CTX_set1_hkdf_salt(ctx, salt.first, int(salt.second));
+    EVP_PKEY_CTX_set1_hkdf_key(ctx, &secret[0], int(size));
+    EVP_PKEY_CTX_add1_hkdf_info(ctx, reinterpret_cast<const uint8_t *>(info.data()), int(info.size()));
+    const auto expanded = EVP_PKEY_derive(ctx, out, &keysize) > 0;
+    EVP_PKEY_CTX_free(ctx);
+    OPENSSL_cleanse(&secret[0], size);
+    if (!expanded || keysize < 8) return 0;
+    return keysize;
+}
+
+// Bounded lru cache of hkdf session keys so reconnecting peers skip a full
+// key agreement. Entries are looked up by a keyed hash of both public keys and
+// the hkdf parameters, expire after ttl, and are zeroed when dropped.
+class session_cache final {
+public:
+    using clock_t = std::chrono::steady_clock;
+
+    explicit session_cache(std::size_t limit = 256, std::chrono::seconds ttl = std::chrono::minutes(10)) noexcept : cache_(limit), ttl_(ttl) {}
+    session_cache(const session_cache&) = delete;
+    auto operator=(const session_cache&) -> auto& = delete;
+
+    auto derive(EVP_PKEY *key, EVP_PKEY *peer, std::string_view info, uint8_t *out, std::size_t max, std::size_t keysize = 0, key_t salt = key_t{nullptr, 0}, const EVP_MD *md = EVP_sha256()) -> std::size_t {
+        if (!key || !peer || !md) return 0;
+        if (!keysize)
+            keysize = EVP_MD_get_size(md);
+        if (keysize > max || keysize > sizeof(entry_t::key)) return 0;
+
+        id_t id{};
+        const auto keyed = make_id(id, key, peer, info, keysize, salt, md);
+        const auto now = clock_t::now();
+        std::size_t size = 0;
+        if (keyed && cache_.find(id, [&](const entry_t& entry) {
+                if (entry.expires <= now) return false;
+                memcpy(out, entry.key, entry.size); // FLawFinder: ignore
+                size = entry.size;
+                return true;
+            })) return size;
+
+        size = derive_shared(key, peer, info, out, max, keysize, salt, md);
+        if (size && keyed)
+            cache_.emplace(id, out, size, now + ttl_);
+        return size;
+    }
+
+    // drop expired entries, such as from a periodic timer
+    auto expire() noexcept {
+        const auto now = clock_t::now();
+        return cache_.erase_if([now](const entry_t& entry) {
+            return entry.expires <= now;
+        });
+    }
+
+    void clear() noexcept {
+        cache_.clear();
+    }
+
+    auto size() const noexcept {
+        return cache_.size();
+    }
+
+    auto hits() const noexcept {
+        return cache_.hits();
+    }
+
+private:
+    struct entry_t final {
+        std::size_t size{0};
+        clock_t::time_point expires;
+        uint8_t key[64]{};
+
+        entry_t(const uint8_t *from, std::size_t count, clock_t::time_point until) noexcept : size(count), expires(until) {
+            memcpy(key, from, size); // FLawFinder: ignore
+        }
+
+        entry_t(const entry_t&) = delete;
+        auto operator=(const entry_t&) -> auto& = delete;
+
+        ~entry_t() {
+            OPENSSL_cleanse(key, sizeof(key));
+        }
+    };
+
+    using id_t = keyed_cache<entry_t>::id_t;
+
+    keyed_cache<entry_t> cache_;
+    std::chrono::seconds ttl_{600};
+
+    static auto add_pubkey(digest_t& hash, EVP_PKEY *key) noexcept -> bool {
+        uint8_t *der{nullptr};
+        auto size = i2d_PUBKEY(key, &der);
+        if (size <= 0) return false;
+        uint8_t len[4];
+        be_set32(len, uint32_t(size));
+        hash.update(len, sizeof(len));
+        hash.update(der, std::size_t(size));
+        OPENSSL_free(der);
+        return true;
+    }
+
+    auto make_id(id_t& id, EVP_PKEY *key, EVP_PKEY *peer, std::string_view info, std::size_t keysize, const key_t& salt, const EVP_MD *md) const noexcept -> bool {
+        auto hash = cache_.hash();
+        if (!add_pubkey(hash, key) || !add_pubkey(hash, peer)) return false;
+        const auto salt_size = salt.first ? salt.second : 0;
+        uint8_t params[16]{};
+        be_set32(params, uint32_t(EVP_MD_get_type(md)));
+        be_set32(params + 4, uint32_t(keysize));
+        be_set32(params + 8, uint32_t(salt_size));
+        be_set32(params + 12, uint32_t(info.size()));
+        hash.update(params, sizeof(params));
+        if (salt_size)
+            hash.update(salt.first, salt_size);
+        hash.update(info);
+        return cache_.make_id(hash, id);
+    }
+};
+
 class eckey_t final {
 public:
     eckey_t() : key_(EVP_EC_gen("secp521r1")) {}
@@ -157,35 +304,15 @@ public:
     }
 
     auto derive(EVP_PKEY *peer, std::string_view info, std::size_t keysize = 0, key_t salt = key_t{nullptr, 0}, const EVP_MD *md = EVP_sha256()) noexcept {
-        if (!peer || !md || keysize > sizeof(aes_key)) return key_t{nullptr, 0};
-        auto ctx = EVP_PKEY_CTX_new(key_, nullptr);
-        if (!ctx) return key_t{nullptr, 0};
-        aes_size = 0;
-        std::size_t size = 0;
-        if (!keysize)
-            keysize = EVP_MD_get_size(md);
-        EVP_PKEY_derive_init(ctx);
-        if ((EVP_PKEY_derive_set_peer(ctx, peer) <= 0) || (EVP_PKEY_derive(ctx, nullptr, &size) <= 0) || (size < 1)) {
-            EVP_PKEY_CTX_free(ctx);
-            return key_t{nullptr, 0};
-        }
-        auto secret = std::make_unique<uint8_t[]>(size);
-        EVP_PKEY_derive(ctx, &secret[0], &size);
-        EVP_PKEY_CTX_free(ctx);
+        aes_size = derive_shared(key_, peer, info, aes_key, sizeof(aes_key), keysize, salt, md);
+        if (!aes_size) return key_t{nullptr, 0};
+        return key_t{aes_key, aes_size};
+    }
 
-        ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr);
-        if (!ctx) return key_t{nullptr, 0};
-        EVP_PKEY_derive_init(ctx);
-        EVP_PKEY_CTX_hkdf_mode(ctx, EVP_PKEY_HKDEF_MODE_EXTRACT_AND_EXPAND);
-        EVP_PKEY_CTX_set_hkdf_md(ctx, md);
-        EVP_PKEY_CTX_set1_hkdf_salt(ctx, salt.first, int(salt.second));
-        EVP_PKEY_CTX_set1_hkdf_key(ctx, &secret[0], int(size));
-        EVP_PKEY_CTX_add1_hkdf_info(ctx, reinterpret_cast<const uint8_t *>(info.data()), int(info.size()));
-        EVP_PKEY_derive(ctx, aes_key, &keysize);
-        EVP_PKEY_CTX_free(ctx);
-        if (keysize < 8) return key_t{nullptr, 0};
-        aes_size = keysize;
-        return key_t{aes_key, keysize};
+    auto derive(session_cache& cache, EVP_PKEY *peer, std::string_view info, std::size_t keysize = 0, key_t salt = key_t{nullptr, 0}, const EVP_MD *md = EVP_sha256()) {
+        aes_size = cache.derive(key_, peer, info, aes_key, sizeof(aes_key), keysize, salt, md);
+        if (!aes_size) return key_t{nullptr, 0};
+        return key_t{aes_key, aes_size};
     }
 
     static auto is_eckey(EVP_PKEY *key) noexcept -> bool {
@@ -197,5 +324,166 @@ private:
     std::size_t aes_size{0};
     uint8_t aes_key[64]{};
 };
+
+// Fixed curve keys held as raw octets, such as ed25519 for signing and x25519
+// for key agreement, which are much faster than the default nist curves.
+template <int Type>
+class rawkey_t final {
+public:
+    rawkey_t() : key_(EVP_PKEY_Q_keygen(nullptr, nullptr, name())) {
+        load_pub();
+    }
+
+    explicit rawkey_t(const std::string& path) noexcept {
+        auto fp = fopen(path.c_str(), "r");
+        if (fp != nullptr) {
+            key_ = PEM_read_PrivateKey(fp, nullptr, nullptr, nullptr);
+            fclose(fp);
+        }
+        if (!is_key(key_)) {
+            EVP_PKEY_free(key_);
+            key_ = nullptr;
+        }
+        load_pub();
+    }
+
+    explicit rawkey_t(const key_t key) noexcept : key_(EVP_PKEY_new_raw_private_key(Type, nullptr, key.first, key.second)) {
+        load_pub();
+    }
+
+    rawkey_t(const rawkey_t& other) noexcept : key_(other.key_), pub_size(other.pub_size), aes_size(other.aes_size) {
+        if (key_)
+            EVP_PKEY_up_ref(key_);
+        memcpy(pub_key, other.pub_key, sizeof(pub_key));  // FLawFinder: ignore
+        memcpy(aes_key, other.aes_key, sizeof(aes_key)); // FLawFinder: ignore
+    }
+
+    ~rawkey_t() {
+        if (key_)
+            EVP_PKEY_free(key_);
+        memset(aes_key, 0, sizeof(aes_key));
+        aes_size = 0;
+    }
+
+    operator EVP_PKEY *() const noexcept {
+        return share();
+    }
+
+    explicit operator bool() const noexcept {
+        return key_ != nullptr;
+    }
+
+    auto operator!() const noexcept {
+        return !key_;
+    }
+
+    auto operator=(const rawkey_t& other) noexcept -> auto& {
+        if (&other == this) return *this;
+        if (key_ == other.key_) return *this;
+        if (key_)
+            EVP_PKEY_free(key_);
+        key_ = other.key_;
+        memcpy(pub_key, other.pub_key, sizeof(pub_key));  // FLawFinder: ignore
+        memcpy(aes_key, other.aes_key, sizeof(aes_key)); // FLawFinder: ignore
+        pub_size = other.pub_size;
+        aes_size = other.aes_size;
+        if (key_)
+            EVP_PKEY_up_ref(key_);
+        return *this;
+    }
+
+    auto share() const noexcept -> EVP_PKEY * {
+        if (key_)
+            EVP_PKEY_up_ref(key_);
+        return key_;
+    }
+
+    // raw public key octets, as exchanged with peers
+    auto pub_raw() const noexcept {
+        if (!pub_size) return key_t{nullptr, 0};
+        return key_t{pub_key, pub_size};
+    }
+
+    auto pub() const noexcept {
+        std::string pem;
+        if (!key_) return pem;
+        auto bp = BIO_new(BIO_s_mem());
+        if (!bp) return pem;
+        if (PEM_write_bio_PUBKEY(bp, key_) == 1) {
+            BUF_MEM *buf{};
+            BIO_get_mem_ptr(bp, &buf);
+            pem = std::string(buf->data, buf->length);
+        }
+        BIO_free(bp);
+        return pem;
+    }
+
+    auto save(const std::string& name) const noexcept -> bool {
+        if (!key_) return false;
+        auto result = false;
+        std::remove(name.c_str());
+
+        auto bio = BIO_new_file(name.c_str(), "w");
+        if (bio) {
+            result = PEM_write_bio_PrivateKey(bio, key_, nullptr, nullptr, 0, nullptr, nullptr) == 1;
+            BIO_free(bio);
+        }
+        return result;
+    }
+
+    auto derived() const noexcept {
+        if (!aes_size) return key_t{nullptr, 0};
+        return key_t{aes_key, aes_size};
+    }
+
+    auto derive(EVP_PKEY *peer, std::string_view info, std::size_t keysize = 0, key_t salt = key_t{nullptr, 0}, const EVP_MD *md = EVP_sha256()) noexcept {
+        static_assert(Type == EVP_PKEY_X25519 || Type == EVP_PKEY_X448, "Key agreement requires x25519 or x448");
+        aes_size = derive_shared(key_, peer, info, aes_key, sizeof(aes_key), keysize, salt, md);
+        if (!aes_size) return key_t{nullptr, 0};
+        return key_t{aes_key, aes_size};
+    }
+
+    auto derive(session_cache& cache, EVP_PKEY *peer, std::string_view info, std::size_t keysize = 0, key_t salt = key_t{nullptr, 0}, const EVP_MD *md = EVP_sha256()) {
+        static_assert(Type == EVP_PKEY_X25519 || Type == EVP_PKEY_X448, "Key agreement requires x25519 or x448");
+        aes_size = cache.derive(key_, peer, info, aes_key, sizeof(aes_key), keysize, salt, md);
+        if (!aes_size) return key_t{nullptr, 0};
+        return key_t{aes_key, aes_size};
+    }
+
+    static auto is_key(EVP_PKEY *key) noexcept -> bool {
+        return key && EVP_PKEY_base_id(key) == Type;
+    }
+
+    static constexpr auto name() noexcept -> const char * {
+        switch (Type) {
+        case EVP_PKEY_ED25519:
+            return "ED25519";
+        case EVP_PKEY_ED448:
+            return "ED448";
+        case EVP_PKEY_X25519:
+            return "X25519";
+        default:
+            return "X448";
+        }
+    }
+
+private:
+    static_assert(Type == EVP_PKEY_ED25519 || Type == EVP_PKEY_ED448 || Type == EVP_PKEY_X25519 || Type == EVP_PKEY_X448, "Unsupported raw key type");
+
+    EVP_PKEY *key_{nullptr};
+    std::size_t pub_size{0};
+    std::size_t aes_size{0};
+    uint8_t pub_key[57]{};
+    uint8_t aes_key[64]{};
+
+    void load_pub() noexcept {
+        pub_size = sizeof(pub_key);
+        if (!key_ || EVP_PKEY_get_raw_public_key(key_, pub_key, &pub_size) != 1)
+            pub_size = 0;
+    }
+};
+
+using ed25519_t = rawkey_t<EVP_PKEY_ED25519>;
+using x25519_t = rawkey_t<EVP_PKEY_X25519>;
 } // namespace tycho::crypto
 #endif
@@ -11,42 +11,30 @@
 #include <array>
 #include <cstring>
 #include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+#include "array.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
 
 namespace tycho::crypto {
 using key_t = std::pair<const uint8_t *, std::size_t>;
 } // namespace tycho::crypto
 
 namespace tycho {
-inline auto to_b64(const uint8_t *data, std::size_t size) {
-    constexpr std::array<char, 64> base64_chars = {
-    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
-    'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
-    'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
-    'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'};
-
-    std::string out;
-
-    for (std::size_t i = 0; i < size; i += 3) {
-        uint32_t c = 0;
-        for (std::size_t j = 0; j < 3; ++j) {
-            c <<= 8;
-            if (i + j < size)
-                c |= uint32_t(data[i + j]);
-        }
+enum class b64_t : uint8_t { standard = 0, url = 1, nopad = 2, url_nopad = 3 };
 
-        out += base64_chars[(c >> 18) & 0x3F];
-        out += base64_chars[(c >> 12) & 0x3F];
-        if (i < (size - 1))
-            out += base64_chars[(c >> 6) & 0x3F];
-        if (i < (size - 2))
-            out += base64_chars[c & 0x3F];
-    }
+constexpr auto is_url(b64_t mode) noexcept {
+    return (uint8_t(mode) & 1) != 0;
+}
 
-    if (size % 3 == 1)
-        out += "==";
-    else if (size % 3 == 2)
-        out += '=';
-    return out;
+constexpr auto is_padded(b64_t mode) noexcept {
+    return (uint8_t(mode) & 2) == 0;
 }
 
 constexpr auto base64_index(char c) {
@@ -58,6 +46,295 @@ constexpr auto base64_index(char c) {
     return -1;
 }
 
+namespace detail {
+inline constexpr char b64_std_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+inline constexpr char b64_url_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+constexpr auto make_b64_table(const char *chars) {
+    std::array<uint8_t, 256> table{};
+    for (auto& entry : table)
+        entry = 0xff;
+    for (uint8_t pos = 0; pos < 64; ++pos)
+        table[uint8_t(chars[pos])] = pos;
+    return table;
+}
+
+inline constexpr auto b64_std_table = make_b64_table(b64_std_chars);
+inline constexpr auto b64_url_table = make_b64_table(b64_url_chars);
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TYCHO_ENCODING_X86
+
+inline auto has_ssse3() noexcept {
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+    return ssse3;
+}
+
+inline auto has_avx2() noexcept {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+__attribute__((target("ssse3"))) inline auto blend128(__m128i a, __m128i b, __m128i mask) noexcept {
+    return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+}
+
+__attribute__((target("ssse3"))) inline auto range128(__m128i v, char lo, char hi) noexcept {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(char(lo - 1))), _mm_cmplt_epi8(v, _mm_set1_epi8(char(hi + 1))));
+}
+
+__attribute__((target("avx2"))) inline auto range256(__m256i v, char lo, char hi) noexcept {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(char(lo - 1))), _mm256_cmpgt_epi8(_mm256_set1_epi8(char(hi + 1)), v));
+}
+
+// Each kernel returns input consumed; the scalar code finishes the rest.
+__attribute__((target("ssse3"))) inline auto b64_encode_ssse3(const uint8_t *in, std::size_t size, char *out, bool url) noexcept {
+    const auto o62 = _mm_set1_epi8(url ? '-' - 62 : '+' - 62);
+    const auto o63 = _mm_set1_epi8(url ? '_' - 63 : '/' - 63);
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 12) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos));
+        v = _mm_shuffle_epi8(v, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        auto hi = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        auto lo = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        auto idx = _mm_or_si128(hi, lo);
+        auto off = _mm_set1_epi8('A');
+        off = blend128(off, _mm_set1_epi8('a' - 26), _mm_cmpgt_epi8(idx, _mm_set1_epi8(25)));
+        off = blend128(off, _mm_set1_epi8('0' - 52), _mm_cmpgt_epi8(idx, _mm_set1_epi8(51)));
+        off = blend128(off, o62, _mm_cmpgt_epi8(idx, _mm_set1_epi8(61)));
+        off = blend128(off, o63, _mm_cmpgt_epi8(idx, _mm_set1_epi8(62)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_add_epi8(idx, off));
+        out += 16;
+    }
+    return pos;
+}
+
+__attribute__((target("avx2"))) inline auto b64_encode_avx2(const uint8_t *in, std::size_t size, char *out, bool url) noexcept {
+    const auto o62 = _mm256_set1_epi8(url ? '-' - 62 : '+' - 62);
+    const auto o63 = _mm256_set1_epi8(url ? '_' - 63 : '/' - 63);
+    const auto shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+    std::size_t pos = 0;
+    for (; pos + 28 <= size; pos += 24) {
+        auto v = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos)));
+        v = _mm256_inserti128_si256(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos + 12)), 1);
+        v = _mm256_shuffle_epi8(v, shuffle);
+        auto hi = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+        auto lo = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+        auto idx = _mm256_or_si256(hi, lo);
+        auto off = _mm256_set1_epi8('A');
+        off = _mm256_blendv_epi8(off, _mm256_set1_epi8('a' - 26), _mm256_cmpgt_epi8(idx, _mm256_set1_epi8(25)));
+        off = _mm256_blendv_epi8(off, _mm256_set1_epi8('0' - 52), _mm256_cmpgt_epi8(idx, _mm256_set1_epi8(51)));
+        off = _mm256_blendv_epi8(off, o62, _mm256_cmpgt_epi8(idx, _mm256_set1_epi8(61)));
+        off = _mm256_blendv_epi8(off, o63, _mm256_cmpgt_epi8(idx, _mm256_set1_epi8(62)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_add_epi8(idx, off));
+        out += 32;
+    }
+    return pos;
+}
+
+// Stops at the first block holding a character outside the alphabet, and
+// never writes past size decoded bytes.
+__attribute__((target("ssse3"))) inline auto b64_decode_ssse3(const char *in, std::size_t len, uint8_t *out, std::size_t size, bool url) noexcept {
+    const auto c62 = _mm_set1_epi8(url ? '-' : '+');
+    const auto c63 = _mm_set1_epi8(url ? '_' : '/');
+    const auto o62 = _mm_set1_epi8(url ? 62 - '-' : 62 - '+');
+    const auto o63 = _mm_set1_epi8(url ? 63 - '_' : 63 - '/');
+    std::size_t pos = 0, used = 0;
+    for (; pos + 16 <= len && used + 16 <= size; pos += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos));
+        auto upper = range128(v, 'A', 'Z');
+        auto lower = range128(v, 'a', 'z');
+        auto digit = range128(v, '0', '9');
+        auto m62 = _mm_cmpeq_epi8(v, c62);
+        auto m63 = _mm_cmpeq_epi8(v, c63);
+        auto valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(m62, m63)));
+        if (_mm_movemask_epi8(valid) != 0xffff) break;
+        auto off = _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+        off = _mm_or_si128(off, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+        off = _mm_or_si128(off, _mm_or_si128(_mm_and_si128(m62, o62), _mm_and_si128(m63, o63)));
+        v = _mm_add_epi8(v, off);
+        v = _mm_madd_epi16(_mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+        v = _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + used), v);
+        used += 12;
+    }
+    return pos;
+}
+
+__attribute__((target("avx2"))) inline auto b64_decode_avx2(const char *in, std::size_t len, uint8_t *out, std::size_t size, bool url) noexcept {
+    const auto c62 = _mm256_set1_epi8(url ? '-' : '+');
+    const auto c63 = _mm256_set1_epi8(url ? '_' : '/');
+    const auto o62 = _mm256_set1_epi8(url ? 62 - '-' : 62 - '+');
+    const auto o63 = _mm256_set1_epi8(url ? 63 - '_' : 63 - '/');
+    const auto shuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    std::size_t pos = 0, used = 0;
+    for (; pos + 32 <= len && used + 32 <= size; pos += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + pos));
+        auto upper = range256(v, 'A', 'Z');
+        auto lower = range256(v, 'a', 'z');
+        auto digit = range256(v, '0', '9');
+        auto m62 = _mm256_cmpeq_epi8(v, c62);
+        auto m63 = _mm256_cmpeq_epi8(v, c63);
+        auto valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(m62, m63)));
+        if (_mm256_movemask_epi8(valid) != -1) break;
+        auto off = _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')), _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        off = _mm256_or_si256(off, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+        off = _mm256_or_si256(off, _mm256_or_si256(_mm256_and_si256(m62, o62), _mm256_and_si256(m63, o63)));
+        v = _mm256_add_epi8(v, off);
+        v = _mm256_madd_epi16(_mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + used), v);
+        used += 24;
+    }
+    return pos;
+}
+#endif
+} // namespace detail
+
+constexpr auto b64_encoded_size(std::size_t size, b64_t mode = b64_t::standard) noexcept {
+    if (is_padded(mode)) return ((size + 2) / 3) * 4;
+    return (size / 3) * 4 + ((size % 3) ? (size % 3) + 1 : 0);
+}
+
+// Encodes into a caller buffer that must hold b64_encoded_size bytes.
+inline auto b64_encode(const uint8_t *in, std::size_t size, char *out, b64_t mode = b64_t::standard) noexcept {
+    const auto chars = is_url(mode) ? detail::b64_url_chars : detail::b64_std_chars;
+    const auto start = out;
+    std::size_t pos = 0;
+#ifdef TYCHO_ENCODING_X86
+    if (size >= 32 && detail::has_avx2()) {
+        pos = detail::b64_encode_avx2(in, size, out, is_url(mode));
+        out += (pos / 3) * 4;
+    }
+    if (size - pos >= 16 && detail::has_ssse3()) {
+        auto used = detail::b64_encode_ssse3(in + pos, size - pos, out, is_url(mode));
+        out += (used / 3) * 4;
+        pos += used;
+    }
+#endif
+    for (; pos + 3 <= size; pos += 3) {
+        const auto v = (uint32_t(in[pos]) << 16) | (uint32_t(in[pos + 1]) << 8) | uint32_t(in[pos + 2]);
+        out[0] = chars[v >> 18];
+        out[1] = chars[(v >> 12) & 0x3f];
+        out[2] = chars[(v >> 6) & 0x3f];
+        out[3] = chars[v & 0x3f];
+        out += 4;
+    }
+
+    switch (size - pos) {
+    case 1: {
+        const auto v = uint32_t(in[pos]) << 16;
+        *(out++) = chars[v >> 18];
+        *(out++) = chars[(v >> 12) & 0x3f];
+        if (is_padded(mode)) {
+            *(out++) = '=';
+            *(out++) = '=';
+        }
+        break;
+    }
+    case 2: {
+        const auto v = (uint32_t(in[pos]) << 16) | (uint32_t(in[pos + 1]) << 8);
+        *(out++) = chars[v >> 18];
+        *(out++) = chars[(v >> 12) & 0x3f];
+        *(out++) = chars[(v >> 6) & 0x3f];
+        if (is_padded(mode))
+            *(out++) = '=';
+        break;
+    }
+    default:
+        break;
+    }
+    return std::size_t(out - start);
+}
+
+inline auto b64_encode(const uint8_t *in, std::size_t size, span<char> out, b64_t mode = b64_t::standard) noexcept {
+    if (out.size() < b64_encoded_size(size, mode)) return std::size_t(0);
+    return b64_encode(in, size, out.data(), mode);
+}
+
+// Appends to a string, growing it once.
+inline auto b64_encode(const uint8_t *in, std::size_t size, std::string& out, b64_t mode = b64_t::standard) {
+    const auto prior = out.size();
+    out.resize(prior + b64_encoded_size(size, mode));
+    return b64_encode(in, size, out.data() + prior, mode);
+}
+
+// Decoded size for strictly valid input, or 0 if the length or padding is
+// malformed for the mode.
+constexpr auto b64_decoded_size(std::string_view from, b64_t mode = b64_t::standard) noexcept {
+    auto len = from.size();
+    if (is_padded(mode)) {
+        if (len % 4) return std::size_t(0);
+        if (len && from[len - 1] == '=') --len;
+        if (len && from[len - 1] == '=') --len;
+    }
+    if (len % 4 == 1) return std::size_t(0);
+    return (len / 4) * 3 + ((len % 4) ? (len % 4) - 1 : 0);
+}
+
+// Strict decode: rejects characters outside the alphabet, misplaced padding,
+// and non-zero trailing bits. Returns bytes decoded, or 0 on error.
+inline auto b64_decode(std::string_view from, uint8_t *out, std::size_t max, b64_t mode = b64_t::standard) noexcept {
+    const auto& table = is_url(mode) ? detail::b64_url_table : detail::b64_std_table;
+    const auto size = b64_decoded_size(from, mode);
+    if (!size || size > max) return std::size_t(0);
+
+    const auto in = from.data();
+    auto len = (size / 3) * 4 + ((size % 3) ? (size % 3) + 1 : 0);
+    std::size_t pos = 0, used = 0;
+#ifdef TYCHO_ENCODING_X86
+    if (len >= 32 && detail::has_avx2()) {
+        pos = detail::b64_decode_avx2(in, len, out, size, is_url(mode));
+        used = (pos / 4) * 3;
+    }
+    if (len - pos >= 16 && detail::has_ssse3()) {
+        auto count = detail::b64_decode_ssse3(in + pos, len - pos, out + used, size - used, is_url(mode));
+        used += (count / 4) * 3;
+        pos += count;
+    }
+#endif
+    for (; pos + 4 <= len; pos += 4) {
+        const auto a = table[uint8_t(in[pos])], b = table[uint8_t(in[pos + 1])];
+        const auto c = table[uint8_t(in[pos + 2])], d = table[uint8_t(in[pos + 3])];
+        if ((a | b | c | d) & 0x80) return std::size_t(0);
+        const auto v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+        out[used++] = uint8_t(v >> 16);
+        out[used++] = uint8_t(v >> 8);
+        out[used++] = uint8_t(v);
+    }
+
+    switch (len - pos) {
+    case 2: {
+        const auto a = table[uint8_t(in[pos])], b = table[uint8_t(in[pos + 1])];
+        if (((a | b) & 0x80) || (b & 0x0f)) return std::size_t(0);
+        out[used++] = uint8_t((a << 2) | (b >> 4));
+        break;
+    }
+    case 3: {
+        const auto a = table[uint8_t(in[pos])], b = table[uint8_t(in[pos + 1])], c = table[uint8_t(in[pos + 2])];
+        if (((a | b | c) & 0x80) || (c & 0x03)) return std::size_t(0);
+        out[used++] = uint8_t((a << 2) | (b >> 4));
+        out[used++] = uint8_t((b << 4) | (c >> 2));
+        break;
+    }
+    default:
+        break;
+    }
+    return used;
+}
+
+inline auto b64_decode(std::string_view from, span<uint8_t> out, b64_t mode = b64_t::standard) noexcept {
+    return b64_decode(from, out.data(), out.size(), mode);
+}
+
+inline auto to_b64(const uint8_t *data, std::size_t size, b64_t mode = b64_t::standard) {
+    std::string out;
+    b64_encode(data, size, out, mode);
+    return out;
+}
+
 inline auto size_b64(std::string_view from) {
     auto size = from.size();
     if (!size) return std::size_t(0);
@@ -78,36 +355,142 @@ inline auto size_b64(std::string_view from) {
     }
 }
 
+// Accepts padded or unpadded standard base64.
 inline auto from_b64(std::string_view from, uint8_t *to, std::size_t maxsize) {
-    auto out = size_b64(from);
-
-    if (out > maxsize) return std::size_t(0);
-    uint32_t val = 0;
-    std::size_t bits = 0, count = 0;
-    for (const auto& ch : from) {
-        if (count >= out) break;
-        auto index = base64_index(ch);
-        if (index >= 0) {
-            val = (val << 6) | uint32_t(index);
-            bits += 6;
-            if (bits >= 8) {
-                to[count++] = (val >> (bits - 8));
-                bits -= 8;
-            }
-        }
+    return b64_decode(from, to, maxsize, (from.size() % 4) ? b64_t::nopad : b64_t::standard);
+}
+
+namespace detail {
+inline constexpr char hex_lower_chars[] = "0123456789abcdef";
+inline constexpr char hex_upper_chars[] = "0123456789ABCDEF";
+
+constexpr auto make_hex_table() {
+    std::array<uint8_t, 256> table{};
+    for (auto& entry : table)
+        entry = 0xff;
+    for (uint8_t pos = 0; pos < 10; ++pos)
+        table['0' + pos] = pos;
+    for (uint8_t pos = 0; pos < 6; ++pos) {
+        table['a' + pos] = uint8_t(10 + pos);
+        table['A' + pos] = uint8_t(10 + pos);
     }
-    return count;
+    return table;
 }
 
-inline auto to_hex(const uint8_t *from, std::size_t size) {
-    std::string out;
-    out.resize(size * 2);
-    auto hex = out.data();
+inline constexpr auto hex_table = make_hex_table();
+
+#ifdef TYCHO_ENCODING_X86
+__attribute__((target("ssse3"))) inline auto hex_encode_ssse3(const uint8_t *in, std::size_t size, char *out, bool upper) noexcept {
+    const auto digits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(upper ? hex_upper_chars : hex_lower_chars));
+    const auto mask = _mm_set1_epi8(0x0f);
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos));
+        auto hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        auto lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), _mm_unpackhi_epi8(hi, lo));
+        out += 32;
+    }
+    return pos;
+}
+
+__attribute__((target("avx2"))) inline auto hex_encode_avx2(const uint8_t *in, std::size_t size, char *out, bool upper) noexcept {
+    const auto digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(upper ? hex_upper_chars : hex_lower_chars)));
+    const auto mask = _mm256_set1_epi8(0x0f);
+    std::size_t pos = 0;
+    for (; pos + 32 <= size; pos += 32) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + pos));
+        auto hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        auto lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, mask));
+        auto first = _mm256_unpacklo_epi8(hi, lo);
+        auto second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+        out += 64;
+    }
+    return pos;
+}
+
+// Converts 16 hex digits to nibbles, or reports a non-hex character.
+__attribute__((target("ssse3"))) inline auto hex_nibbles128(__m128i v, __m128i& out) noexcept {
+    const auto digit = range128(v, '0', '9');
+    const auto folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    const auto alpha = range128(folded, 'a', 'f');
+    if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xffff) return false;
+    out = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))), _mm_and_si128(alpha, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+    return true;
+}
+
+__attribute__((target("ssse3"))) inline auto hex_decode_ssse3(const char *in, std::size_t size, uint8_t *out) noexcept {
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        __m128i nibbles;
+        if (!hex_nibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos * 2)), nibbles)) break;
+        auto first = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+        if (!hex_nibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + pos * 2 + 16)), nibbles)) break;
+        auto second = _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pos), _mm_packus_epi16(first, second));
+    }
+    return pos;
+}
+#endif
+} // namespace detail
+
+// Encodes into a caller buffer that must hold size * 2 characters.
+inline auto hex_encode(const uint8_t *in, std::size_t size, char *out, bool upper = false) noexcept {
+    const auto chars = upper ? detail::hex_upper_chars : detail::hex_lower_chars;
+    std::size_t pos = 0;
+#ifdef TYCHO_ENCODING_X86
+    if (size >= 32 && detail::has_avx2())
+        pos = detail::hex_encode_avx2(in, size, out, upper);
+    if (size - pos >= 16 && detail::has_ssse3())
+        pos += detail::hex_encode_ssse3(in + pos, size - pos, out + pos * 2, upper);
+#endif
+    for (; pos < size; ++pos) {
+        out[pos * 2] = chars[in[pos] >> 4];
+        out[pos * 2 + 1] = chars[in[pos] & 0x0f];
+    }
+    return size * 2;
+}
+
+inline auto hex_encode(const uint8_t *in, std::size_t size, span<char> out, bool upper = false) noexcept {
+    if (out.size() < size * 2) return std::size_t(0);
+    return hex_encode(in, size, out.data(), upper);
+}
+
+inline auto hex_encode(const uint8_t *in, std::size_t size, std::string& out, bool upper = false) {
+    const auto prior = out.size();
+    out.resize(prior + size * 2);
+    return hex_encode(in, size, out.data() + prior, upper);
+}
 
-    for (auto pos = std::size_t(0); pos < size; ++pos) {
-        snprintf(hex, 3, "%02x", from[pos]);
-        hex += 2;
+// Decodes up to max bytes of either case, stopping at the first pair that
+// is not hex. Returns bytes decoded; a trailing odd digit is ignored.
+inline auto hex_decode(std::string_view from, uint8_t *out, std::size_t max) noexcept {
+    const auto in = from.data();
+    const auto size = std::min(from.size() / 2, max);
+    std::size_t pos = 0;
+#ifdef TYCHO_ENCODING_X86
+    if (size >= 16 && detail::has_ssse3())
+        pos = detail::hex_decode_ssse3(in, size, out);
+#endif
+    for (; pos < size; ++pos) {
+        const auto hi = detail::hex_table[uint8_t(in[pos * 2])];
+        const auto lo = detail::hex_table[uint8_t(in[pos * 2 + 1])];
+        if ((hi | lo) & 0x80) break;
+        out[pos] = uint8_t((hi << 4) | lo);
     }
+    return pos;
+}
+
+inline auto hex_decode(std::string_view from, span<uint8_t> out) noexcept {
+    return hex_decode(from, out.data(), out.size());
+}
+
+inline auto to_hex(const uint8_t *from, std::size_t size, bool upper = false) {
+    std::string out;
+    hex_encode(from, size, out, upper);
     return out;
 }
 
@@ -120,26 +503,342 @@ inline auto to_hex(const crypto::key_t& key) {
 }
 
 inline auto from_hex(std::string_view from, uint8_t *to, std::size_t size) {
-    auto hex = from.data();
-    auto maxsize = size * 2;
-    maxsize = std::min(from.size(), maxsize);
-    for (auto pos = std::size_t(0); pos < maxsize; pos += 2) {
-        char buf[3]{};
-        buf[0] = hex[pos];
-        buf[1] = hex[pos + 1];
-        buf[2] = 0;
-        char *end = nullptr;
-        auto value = strtoul(buf, &end, 16);
-        if (*end != 0) return pos / 2;
-        *(to++) = uint8_t(value);
-    }
-    return maxsize / 2;
+    return hex_decode(from, to, size);
 }
+
+// Incremental codecs carry partial groups across chunk boundaries. Each
+// output_size(n) is the most a call with n bytes of input can produce.
+class b64_encoder final {
+public:
+    explicit b64_encoder(b64_t mode = b64_t::standard) noexcept : mode_(mode) {}
+
+    static constexpr auto output_size(std::size_t size) noexcept {
+        return ((size + 2) / 3 + 1) * 4;
+    }
+
+    auto update(const uint8_t *in, std::size_t size, char *out) noexcept {
+        std::size_t used = 0;
+        if (count_) {
+            while (count_ < 3 && size) {
+                carry_[count_++] = *(in++);
+                --size;
+            }
+            if (count_ < 3) return used;
+            used = b64_encode(carry_, 3, out, mode_);
+            count_ = 0;
+        }
+        const auto full = size - (size % 3);
+        used += b64_encode(in, full, out + used, mode_);
+        count_ = size - full;
+        memcpy(carry_, in + full, count_);
+        return used;
+    }
+
+    auto finish(char *out) noexcept {
+        auto used = b64_encode(carry_, count_, out, mode_);
+        count_ = 0;
+        return used;
+    }
+
+private:
+    b64_t mode_;
+    uint8_t carry_[3]{0};
+    std::size_t count_{0};
+};
+
+class b64_decoder final {
+public:
+    explicit b64_decoder(b64_t mode = b64_t::standard) noexcept : mode_(mode) {}
+
+    explicit operator bool() const noexcept {
+        return !failed_;
+    }
+
+    auto operator!() const noexcept {
+        return failed_;
+    }
+
+    static constexpr auto output_size(std::size_t size) noexcept {
+        return ((size + 3) / 4) * 3;
+    }
+
+    // Returns bytes decoded, or 0 and fails on invalid input.
+    auto update(std::string_view text, uint8_t *out) noexcept -> std::size_t {
+        if (failed_ || text.empty()) return 0;
+        if (done_) return fail();
+        std::size_t used = 0;
+        if (count_) {
+            while (count_ < 4 && !text.empty()) {
+                carry_[count_++] = text.front();
+                text.remove_prefix(1);
+            }
+            if (count_ < 4) return 0;
+            count_ = 0;
+            used = block(std::string_view(carry_, 4), out);
+            if (failed_) return 0;
+        }
+
+        const auto full = text.size() - (text.size() % 4);
+        if (full) {
+            if (done_) return fail();
+            used += block(text.substr(0, full), out + used);
+            if (failed_) return 0;
+        }
+
+        count_ = text.size() - full;
+        if (count_) {
+            if (done_) return fail();
+            memcpy(carry_, text.data() + full, count_);
+        }
+        return used;
+    }
+
+    // Decodes an unpadded tail, and fails on a truncated padded stream.
+    auto finish(uint8_t *out) noexcept -> std::size_t {
+        if (failed_) return 0;
+        std::size_t used = 0;
+        if (count_) {
+            if (is_padded(mode_)) return fail();
+            used = b64_decode(std::string_view(carry_, count_), out, 3, mode_);
+            if (!used) return fail();
+        }
+        count_ = 0;
+        done_ = true;
+        return used;
+    }
+
+    void reset() noexcept {
+        count_ = 0;
+        done_ = failed_ = false;
+    }
+
+private:
+    b64_t mode_;
+    char carry_[4]{0};
+    std::size_t count_{0};
+    bool done_{false}, failed_{false};
+
+    auto fail() noexcept -> std::size_t {
+        failed_ = true;
+        return 0;
+    }
+
+    auto block(std::string_view quads, uint8_t *out) noexcept -> std::size_t {
+        const auto used = b64_decode(quads, out, b64_decoded_size(quads, mode_), mode_);
+        if (!used) return fail();
+        if (quads.back() == '=') done_ = true;
+        return used;
+    }
+};
+
+class hex_encoder final {
+public:
+    explicit hex_encoder(bool upper = false) noexcept : upper_(upper) {}
+
+    static constexpr auto output_size(std::size_t size) noexcept {
+        return size * 2;
+    }
+
+    auto update(const uint8_t *in, std::size_t size, char *out) const noexcept {
+        return hex_encode(in, size, out, upper_);
+    }
+
+    static auto finish([[maybe_unused]] char *out) noexcept {
+        return std::size_t(0);
+    }
+
+private:
+    bool upper_;
+};
+
+class hex_decoder final {
+public:
+    explicit operator bool() const noexcept {
+        return !failed_;
+    }
+
+    auto operator!() const noexcept {
+        return failed_;
+    }
+
+    static constexpr auto output_size(std::size_t size) noexcept {
+        return size / 2 + 1;
+    }
+
+    auto update(std::string_view text, uint8_t *out) noexcept -> std::size_t {
+        if (failed_ || text.empty()) return 0;
+        std::size_t used = 0;
+        if (pending_) {
+            const char pair[2] = {carry_, text.front()};
+            if (hex_decode(std::string_view(pair, 2), out, 1) != 1) return fail();
+            text.remove_prefix(1);
+            pending_ = false;
+            ++used;
+        }
+
+        const auto full = text.size() / 2;
+        if (hex_decode(text, out + used, full) != full) return fail();
+        used += full;
+        if (text.size() % 2) {
+            carry_ = text.back();
+            pending_ = true;
+        }
+        return used;
+    }
+
+    auto finish([[maybe_unused]] uint8_t *out) noexcept -> std::size_t {
+        if (pending_) return fail();
+        return 0;
+    }
+
+    void reset() noexcept {
+        pending_ = failed_ = false;
+    }
+
+private:
+    char carry_{0};
+    bool pending_{false}, failed_{false};
+
+    auto fail() noexcept -> std::size_t {
+        failed_ = true;
+        return 0;
+    }
+};
+
+// Output filter: binary written here is encoded as text to a sink stream.
+// Call finish (or destroy) to emit any trailing group and padding.
+template <typename Encoder, std::size_t S = 3072>
+class encode_ostream : protected std::streambuf, public std::ostream {
+public:
+    encode_ostream() = delete;
+    encode_ostream(const encode_ostream&) = delete;
+    auto operator=(const encode_ostream&) -> auto& = delete;
+
+    template <typename... Args>
+    explicit encode_ostream(std::ostream& sink, Args&&...args) : std::ostream(static_cast<std::streambuf *>(this)), sink_(sink), codec_(std::forward<Args>(args)...), text_(Encoder::output_size(S)) {
+        setp(data_, data_ + S);
+    }
+
+    ~encode_ostream() override {
+        finish();
+    }
+
+    auto finish() -> bool {
+        if (finished_) return static_cast<bool>(sink_);
+        finished_ = true;
+        if (!drain()) return false;
+        auto used = codec_.finish(text_.data());
+        if (used)
+            sink_.write(text_.data(), std::streamsize(used));
+        sink_.flush();
+        return static_cast<bool>(sink_);
+    }
+
+protected:
+    std::ostream& sink_;
+    Encoder codec_;
+    std::vector<char> text_;
+    char data_[S]{0};
+    bool finished_{false};
+
+    auto encode(const char *in, std::size_t size) {
+        auto used = codec_.update(reinterpret_cast<const uint8_t *>(in), size, text_.data());
+        if (used)
+            sink_.write(text_.data(), std::streamsize(used));
+        return static_cast<bool>(sink_);
+    }
+
+    auto drain() -> bool {
+        auto size = std::size_t(pptr() - pbase());
+        setp(data_, data_ + S);
+        return !size || encode(data_, size);
+    }
+
+    auto sync() -> int override {
+        if (finished_ || !drain()) return -1;
+        sink_.flush();
+        return sink_ ? 0 : -1;
+    }
+
+    auto overflow(int ch) -> int override {
+        if (finished_ || !drain()) return EOF;
+        if (ch == EOF) return std::streambuf::traits_type::not_eof(ch);
+        *pptr() = std::streambuf::traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    // large writes bypass the put area and are encoded in S sized blocks
+    auto xsputn(const char *in, std::streamsize size) -> std::streamsize override {
+        if (finished_ || size < 0) return 0;
+        if (std::size_t(size) < S - std::size_t(pptr() - pbase())) return std::streambuf::xsputn(in, size);
+        if (!drain()) return 0;
+        std::streamsize total = 0;
+        while (size - total >= std::streamsize(S)) {
+            if (!encode(in + total, S)) return total;
+            total += S;
+        }
+        return total + std::streambuf::xsputn(in + total, size - total);
+    }
+};
+
+// Input filter: text read from a source stream is decoded as binary. A
+// malformed source sets badbit.
+template <typename Decoder, std::size_t S = 4096>
+class decode_istream : protected std::streambuf, public std::istream {
+public:
+    decode_istream() = delete;
+    decode_istream(const decode_istream&) = delete;
+    auto operator=(const decode_istream&) -> auto& = delete;
+
+    template <typename... Args>
+    explicit decode_istream(std::istream& source, Args&&...args) : std::istream(static_cast<std::streambuf *>(this)), source_(source), codec_(std::forward<Args>(args)...), data_(Decoder::output_size(S) + 3) {
+        setg(data_.data(), data_.data(), data_.data());
+    }
+
+protected:
+    std::istream& source_;
+    Decoder codec_;
+    std::vector<char> data_;
+    char text_[S]{0};
+    bool done_{false};
+
+    auto underflow() -> int override {
+        if (gptr() < egptr()) return std::streambuf::traits_type::to_int_type(*gptr());
+        auto out = reinterpret_cast<uint8_t *>(data_.data());
+        while (!done_) {
+            std::size_t used = 0;
+            source_.read(text_, S);
+            auto count = std::size_t(source_.gcount());
+            if (count)
+                used = codec_.update(std::string_view(text_, count), out);
+            else {
+                used = codec_.finish(out);
+                done_ = true;
+            }
+            if (!codec_) {
+                done_ = true;
+                setstate(std::ios::badbit);
+                return EOF;
+            }
+            if (used) {
+                setg(data_.data(), data_.data(), data_.data() + used);
+                return std::streambuf::traits_type::to_int_type(*gptr());
+            }
+        }
+        return EOF;
+    }
+};
+
+using b64_ostream = encode_ostream<b64_encoder>;
+using hex_ostream = encode_ostream<hex_encoder>;
+using b64_istream = decode_istream<b64_decoder>;
+using hex_istream = decode_istream<hex_decoder>;
 } // namespace tycho
 
 namespace tycho::crypto {
-inline auto to_b64(const uint8_t *from, size_t size) {
-    return tycho::to_b64(from, size);
+inline auto to_b64(const uint8_t *from, size_t size, b64_t mode = b64_t::standard) {
+    return tycho::to_b64(from, size, mode);
 }
 
 inline auto to_b64(const key_t& key) {
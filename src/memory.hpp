@@ -42,20 +42,20 @@ public:
     shared_mem() = default;
     shared_mem(const shared_mem& other) = default;
 
-    explicit shared_mem(size_type size) : array_(std::make_shared<T>(size)), size_(size) {}
+    explicit shared_mem(size_type size) : array_(make(size)), size_(size) {}
 
-    shared_mem(size_type size, const T& init) : array_(std::make_shared<T>(size)), size_(size) {
+    shared_mem(size_type size, const T& init) : array_(make(size)), size_(size) {
         std::fill(data(), data() + size, init);
     }
 
     template <typename U = T, std::enable_if_t<sizeof(U) == 1, int> = 0>
     shared_mem(const crypto::key_t& key) : // cppcheck-suppress noExplicitConstructor
-                                           array_(key.second ? std::make_shared<T>(uint32_t(key.second / sizeof(T))) : nullptr), size_(key.second / sizeof(T)) {
+                                           array_(key.second ? make(uint32_t(key.second / sizeof(T))) : nullptr), size_(key.second / sizeof(T)) {
         if (size_)
             memcpy(array_.get(), key.first, key.second);
     }
 
-    shared_mem(const T *from, size_type size) : array_(size ? std::make_shared<T>(size) : nullptr), size_(size) {
+    shared_mem(const T *from, size_type size) : array_(size ? make(size) : nullptr), size_(size) {
         if (size)
             memcpy(array_.get(), from, sizeof(T) * size);
     }
@@ -102,7 +102,7 @@ public:
 
     auto operator[](size_type index) const -> const T& {
         if (index >= size_) throw std::out_of_range("Index is out of range");
-        return array_[index];
+        return array_.get()[index];
     }
 
     auto operator*() noexcept -> uint8_t * {
@@ -187,7 +187,7 @@ public:
     }
 
     auto view() const {
-        return size_ ? std::string_view(reinterpret_cast<const char *>(&array_[0]), size_ * sizeof(T)) : std::string_view();
+        return size_ ? std::string_view(reinterpret_cast<const char *>(array_.get()), size_ * sizeof(T)) : std::string_view();
     }
 
     auto count() const {
@@ -204,11 +204,11 @@ public:
     }
 
     auto to_hex() const {
-        return to_hex(data(), size_bytes());
+        return tycho::to_hex(reinterpret_cast<const uint8_t *>(data()), size_bytes());
     }
 
     auto to_b64() const {
-        return to_b64(data(), size_bytes());
+        return tycho::to_b64(reinterpret_cast<const uint8_t *>(data()), size_bytes());
     }
 
     auto begin() const {
@@ -248,7 +248,7 @@ public:
                 ++bsize;
         }
         auto mem = shared_mem(uint32_t(bsize / sizeof(T)));
-        if (tycho::from_hex(from, mem.get(), bsize) < from.size() / 2) return shared_mem();
+        if (tycho::hex_decode(from, reinterpret_cast<uint8_t *>(mem.data()), bsize) < from.size() / 2) return shared_mem();
         return mem;
     }
 
@@ -258,7 +258,7 @@ public:
         while (sizeof(T) > 1 && alloc % sizeof(T))
             ++alloc;
         auto mem = shared_mem(uint32_t(alloc / sizeof(T)));
-        if (tycho::from_b64(from, mem.get(), bsize) < bsize) return shared_mem();
+        if (tycho::from_b64(from, reinterpret_cast<uint8_t *>(mem.data()), bsize) < bsize) return shared_mem();
         return mem;
     }
 
@@ -267,6 +267,10 @@ private:
 
     std::shared_ptr<T> array_;
     size_type size_{0};
+
+    static auto make(size_type size) {
+        return std::shared_ptr<T>(new T[size](), std::default_delete<T[]>());
+    }
 };
 
 template <typename T>
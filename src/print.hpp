@@ -9,14 +9,41 @@
 #include <functional>
 #include <iostream>
 #include <string_view>
+#include <string>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <chrono>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
 
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
 
+#if __has_include(<sys/uio.h>)
+#define TYCHO_LOG_WRITEV
+#include <sys/uio.h>
+#include <poll.h>
+#else
+namespace tycho {
+struct iovec {
+    void *iov_base;
+    std::size_t iov_len;
+};
+} // namespace tycho
+#endif
+
 #if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__) || defined(WIN32)
 #ifndef quick_exit
 #define quick_exit(x) ::exit(x)      // NOLINT
@@ -46,6 +73,581 @@ constexpr auto LOG_PID = 0;
 #endif
 #endif
 
+namespace tycho {
+enum class log_policy : uint8_t { drop = 0, block = 1 };
+
+namespace detail {
+template <class... Args>
+auto log_vformat(const char *fmt, const Args&...args) -> std::string;
+
+// text arguments are copied by value; anything else must be raw bytes
+template <typename T>
+inline constexpr bool log_text_v = std::is_convertible_v<const T&, std::string_view>;
+
+template <typename T>
+inline constexpr bool log_storable_v = log_text_v<T> || std::is_trivially_copyable_v<T>;
+
+template <typename T>
+using log_stored_t = std::conditional_t<log_text_v<T>, std::string_view, std::decay_t<T>>;
+
+template <typename T>
+constexpr auto log_size(const T& arg) noexcept -> std::size_t {
+    if constexpr (log_text_v<T>)
+        return sizeof(uint32_t) + std::string_view(arg).size();
+    else
+        return sizeof(T);
+}
+
+template <typename T>
+inline void log_store(char *& out, const T& arg) noexcept {
+    if constexpr (log_text_v<T>) {
+        const std::string_view text(arg);
+        const auto size = uint32_t(text.size());
+        memcpy(out, &size, sizeof(size));
+        memcpy(out + sizeof(size), text.data(), size);
+        out += sizeof(size) + size;
+    } else {
+        memcpy(out, &arg, sizeof(T));
+        out += sizeof(T);
+    }
+}
+
+template <typename T>
+inline auto log_take(const char *& in) noexcept -> log_stored_t<T> {
+    if constexpr (log_text_v<T>) {
+        uint32_t size{0};
+        memcpy(&size, in, sizeof(size));
+        in += sizeof(size) + size;
+        return std::string_view(in - size, size);
+    } else {
+        std::decay_t<T> value;
+        memcpy(&value, in, sizeof(value));
+        in += sizeof(value);
+        return value;
+    }
+}
+
+// Counts callers inside a logging call so debug builds can catch a mode
+// switch racing with other threads; free in release builds.
+class log_scope final {
+public:
+    explicit log_scope([[maybe_unused]] std::atomic<unsigned>& active) noexcept
+#ifndef NDEBUG
+        : active_(active) {
+        active_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    ~log_scope() {
+        active_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<unsigned>& active_;
+#else
+    {
+    }
+#endif
+};
+
+// Formats registered by deferred record call sites; the index is the id.
+struct log_registry final {
+    std::mutex lock;
+    std::vector<const char *> formats;
+};
+
+inline auto log_formats() -> log_registry& {
+    static log_registry registry;
+    return registry;
+}
+
+inline auto log_enroll(const char *fmt) -> uint32_t {
+    auto& registry = log_formats();
+    const std::lock_guard lock(registry.lock);
+    registry.formats.push_back(fmt);
+    return uint32_t(registry.formats.size() - 1);
+}
+
+inline auto log_lookup(uint32_t id) -> const char * {
+    auto& registry = log_formats();
+    const std::lock_guard lock(registry.lock);
+    return id < registry.formats.size() ? registry.formats[id] : nullptr;
+}
+
+template <class... Args>
+auto log_decode(const char *fmt, [[maybe_unused]] const char *data) -> std::string {
+    // braced init evaluates in order, matching how arguments were stored
+    const std::tuple<log_stored_t<Args>...> values{log_take<Args>(data)...};
+    return std::apply([fmt](const auto&...unpacked) { return log_vformat(fmt, unpacked...); }, values);
+}
+} // namespace detail
+
+// Log records drained by one writer thread. Each producer thread gets its
+// own single producer ring, so queueing a record is a space check against
+// a cached tail, a copy, and a release store of head. The writer batches
+// ready records from all rings to fd with writev, forwards them to syslog
+// and notify, and frees the rings of exited threads once they are empty.
+class log_async final {
+public:
+    using notify_t = std::function<void(const std::string&, const char *)>;
+
+    enum kind_t : unsigned { debug = 0, info, notice, warn, error, fail, crit };
+
+    log_async(const log_async&) = delete;
+    auto operator=(const log_async&) -> auto& = delete;
+
+    // capacity is the ring size for each thread that logs
+    explicit log_async(notify_t notify, std::size_t capacity = 1 << 16, log_policy policy = log_policy::drop, int fd = 2) : notify_(std::move(notify)), policy_(policy), fd_(fd), instance_(next_instance()) {
+        while (capacity_ < capacity && capacity_ < (std::size_t(1) << 25))
+            capacity_ <<= 1;
+        writer_ = std::thread([this] { run(); });
+    }
+
+    ~log_async() {
+        flush();
+        stop_.store(true);
+        wake();
+        if (writer_.joinable())
+            writer_.join();
+    }
+
+    // records lost to a full ring or to a console write that failed
+    auto dropped() const noexcept -> uint64_t {
+        const std::lock_guard lock(rings_lock_);
+        auto total = retired_ + unwritten_.load(std::memory_order_relaxed);
+        for (const auto& ring : rings_)
+            total += ring->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    auto policy() const noexcept {
+        return policy_;
+    }
+
+    auto capacity() const noexcept {
+        return capacity_;
+    }
+
+    // replace the notify handler; waits for a batch being notified
+    void notify(notify_t handler) {
+        const std::lock_guard lock(notify_lock_);
+        notify_ = std::move(handler);
+    }
+
+    static auto label(unsigned kind) noexcept -> std::string_view {
+        constexpr std::string_view labels[] = {"debug: ", "info: ", "notice: ", "warn: ", "error: ", "fail: ", "crit: "};
+        return labels[kind % 7];
+    }
+
+    static auto type(unsigned kind) noexcept -> const char * {
+        constexpr const char *types[] = {"debug", "info", "notice", "warning", "error", "fatal", "fatal"};
+        return types[kind % 7];
+    }
+
+    // queue one message; false if dropped because the ring is full
+    auto push(kind_t kind, std::string_view msg, bool console, bool wait = false) noexcept -> bool {
+        msg = msg.substr(0, std::min(msg.size(), capacity_ / 4));
+        auto ring = local();
+        char *out{nullptr};
+        if (!ring || !reserve(*ring, msg.size(), out, wait)) return false;
+        memcpy(out, msg.data(), msg.size());
+        commit(*ring, out, (console ? to_console : 0) | (uint32_t(kind) << 26) | uint32_t(msg.size()));
+        return true;
+    }
+
+    // Queue a registered format id and raw argument bytes; the writer
+    // thread formats them.
+    template <class... Args>
+    auto write(kind_t kind, bool console, uint32_t id, const Args&...args) noexcept -> bool {
+        static_assert((detail::log_storable_v<Args> && ...), "Binary log arguments must be text or trivially copyable");
+        const auto size = sizeof(decode_t) + sizeof(id) + (std::size_t(0) + ... + detail::log_size(args));
+        auto ring = local();
+        if (!ring) return false;
+        if (size > capacity_ / 4) {
+            ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        char *out{nullptr};
+        if (!reserve(*ring, size, out, false)) return false;
+        auto data = out;
+        const decode_t decode = &detail::log_decode<Args...>;
+        memcpy(data, &decode, sizeof(decode));
+        memcpy(data + sizeof(decode), &id, sizeof(id));
+        data += sizeof(decode) + sizeof(id);
+        (detail::log_store(data, args), ...);
+        commit(*ring, out, binary | (console ? to_console : 0) | (uint32_t(kind) << 26) | uint32_t(size));
+        return true;
+    }
+
+    // wait until everything queued so far has been written
+    void flush() noexcept {
+        try {
+            std::vector<std::pair<std::shared_ptr<ring_t>, uint64_t>> targets;
+            {
+                const std::lock_guard lock(rings_lock_);
+                for (const auto& ring : rings_)
+                    targets.emplace_back(ring, ring->head.load(std::memory_order_acquire));
+            }
+            for (const auto& [ring, target] : targets) {
+                while (ring->tail.load(std::memory_order_acquire) < target && writer_.joinable()) {
+                    wake();
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        } catch (...) { // NOLINT
+        }
+    }
+
+private:
+    using decode_t = std::string (*)(const char *, const char *);
+
+    // head and the producer fields stay apart from what the writer moves
+    struct ring_t final {
+        explicit ring_t(std::size_t size) : data(std::make_unique<char[]>(size)) {}
+
+        std::unique_ptr<char[]> data;
+        alignas(64) std::atomic<uint64_t> head{0};
+        uint64_t cached{0}, next{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<bool> closed{false};
+        alignas(64) std::atomic<uint64_t> tail{0};
+    };
+
+    // per thread rings of the last few loggers used; closed on thread exit
+    struct local_t final {
+        struct slot_t {
+            uint64_t instance{0};
+            std::shared_ptr<ring_t> ring;
+        };
+
+        slot_t slots[4];
+        unsigned next{0};
+
+        ~local_t() {
+            for (auto& slot : slots) {
+                if (slot.ring) slot.ring->closed.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    static constexpr std::size_t unit = 8;
+    static constexpr uint32_t padding = 1U << 30;
+    static constexpr uint32_t to_console = 1U << 29;
+    static constexpr uint32_t binary = 1U << 25;
+    static constexpr uint32_t size_mask = (1U << 25) - 1;
+
+    notify_t notify_;
+    std::size_t capacity_{4096};
+    log_policy policy_{log_policy::drop};
+    int fd_{2};
+    uint64_t instance_{0};
+    mutable std::mutex rings_lock_;
+    std::vector<std::shared_ptr<ring_t>> rings_;
+    uint64_t retired_{0};
+    std::atomic<uint64_t> unwritten_{0};
+    std::vector<std::shared_ptr<ring_t>> active_;
+    std::vector<uint64_t> tails_;
+    std::size_t start_{0};
+    std::atomic<bool> joined_{false}, idle_{false}, stop_{false};
+    std::mutex lock_, notify_lock_;
+    std::condition_variable cond_;
+    std::thread writer_;
+
+    static auto next_instance() noexcept -> uint64_t {
+        static std::atomic<uint64_t> instances{0};
+        return instances.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static constexpr auto units(std::size_t size) noexcept -> std::size_t {
+        return (size + unit - 1) / unit;
+    }
+
+    void wake() noexcept {
+        const std::lock_guard lock(lock_);
+        cond_.notify_one();
+    }
+
+    auto local() noexcept -> ring_t * {
+        thread_local local_t cache;
+        for (auto& slot : cache.slots) {
+            if (slot.instance == instance_) return slot.ring.get();
+        }
+        return attach(cache);
+    }
+
+    // first record from this thread, or its slot was reused by other loggers
+    auto attach(local_t& cache) noexcept -> ring_t * {
+        try {
+            auto ring = std::make_shared<ring_t>(capacity_);
+            {
+                const std::lock_guard lock(rings_lock_);
+                rings_.push_back(ring);
+            }
+            joined_.store(true, std::memory_order_release);
+            auto& slot = cache.slots[cache.next++ % 4];
+            if (slot.ring) slot.ring->closed.store(true, std::memory_order_release);
+            slot.instance = instance_;
+            slot.ring = std::move(ring);
+            return slot.ring.get();
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    // claim ring space for a header and size bytes; out is where to write
+    auto reserve(ring_t& ring, std::size_t size, char *& out, bool wait) noexcept -> bool {
+        const auto need = (units(size) + 1) * unit;
+        const auto head = ring.head.load(std::memory_order_relaxed);
+        const auto offset = std::size_t(head & (capacity_ - 1));
+        const auto contig = capacity_ - offset;
+        const auto total = (need <= contig) ? need : contig + need;
+        while (head + total - ring.cached > capacity_) {
+            ring.cached = ring.tail.load(std::memory_order_acquire);
+            if (head + total - ring.cached <= capacity_) break;
+            if (!wait && policy_ == log_policy::drop) {
+                ring.dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            wake();
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        auto base = ring.data.get();
+        if (need > contig) {
+            const auto mark = padding | uint32_t(contig);
+            memcpy(base + offset, &mark, sizeof(mark));
+            out = base + unit;
+        } else
+            out = base + offset + unit;
+        ring.next = head + total;
+        return true;
+    }
+
+    // Publish with a release store; only the producer that clears idle
+    // pays for waking the writer. A wake lost to a writer just going idle
+    // is picked up by its poll.
+    void commit(ring_t& ring, char *out, uint32_t mark) noexcept {
+        memcpy(out - unit, &mark, sizeof(mark));
+        ring.head.store(ring.next, std::memory_order_release);
+        if (idle_.load(std::memory_order_relaxed) && idle_.exchange(false)) wake();
+    }
+
+    // returns how many trailing entries were not fully written
+    auto output(const iovec *iov, int count) noexcept -> int {
+#ifdef TYCHO_LOG_WRITEV
+        while (count > 0) {
+            auto sent = ::writev(fd_, iov, std::min(count, 1020));
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && policy_ == log_policy::block && writable()) continue;
+            if (sent <= 0) return count;
+            // advance past a partial write
+            while (count > 0 && std::size_t(sent) >= iov->iov_len) {
+                sent -= ssize_t(iov->iov_len);
+                ++iov;
+                --count;
+            }
+            if (count > 0 && sent > 0) {
+                iovec rest{static_cast<char *>(iov->iov_base) + sent, iov->iov_len - std::size_t(sent)};
+                if (output(&rest, 1)) return count;
+                ++iov;
+                --count;
+            }
+        }
+#else
+        for (int pos = 0; pos < count; ++pos)
+            fwrite(iov[pos].iov_base, 1, iov[pos].iov_len, stderr);
+        fflush(stderr);
+#endif
+        return 0;
+    }
+
+#ifdef TYCHO_LOG_WRITEV
+    // a non-blocking console is waited on rather than dropped when blocking
+    auto writable() const noexcept -> bool {
+        struct pollfd pfd{};
+        pfd.fd = fd_;
+        pfd.events = POLLOUT;
+        return ::poll(&pfd, 1, 1000) > 0 && (pfd.revents & POLLOUT) != 0;
+    }
+#endif
+
+    // pick up rings of threads that started logging
+    void adopt() {
+        if (!joined_.exchange(false, std::memory_order_acquire)) return;
+        const std::lock_guard lock(rings_lock_);
+        active_ = rings_;
+    }
+
+    // free rings of exited threads once the writer has emptied them
+    void retire() {
+        for (std::size_t pos = 0; pos < active_.size();) {
+            auto& ring = active_[pos];
+            if (!ring->closed.load(std::memory_order_acquire) || ring->tail.load(std::memory_order_relaxed) != ring->head.load(std::memory_order_acquire)) {
+                ++pos;
+                continue;
+            }
+            const std::lock_guard lock(rings_lock_);
+            retired_ += ring->dropped.load(std::memory_order_relaxed);
+            rings_.erase(std::find(rings_.begin(), rings_.end(), ring));
+            active_.erase(active_.begin() + std::ptrdiff_t(pos));
+        }
+    }
+
+    auto pending() const noexcept {
+        if (joined_.load()) return true;
+        for (const auto& ring : active_) {
+            if (ring->tail.load(std::memory_order_relaxed) != ring->head.load(std::memory_order_acquire)) return true;
+        }
+        return false;
+    }
+
+    // writes one batch of ready records; true if ring space was released
+    auto drain() -> bool {
+        constexpr std::size_t batch = 340;
+        iovec iov[batch * 3];
+        struct record {
+            uint32_t mark;
+            const char *text;
+        } records[batch];
+        std::string decoded[batch];
+        std::size_t count{0}, lines{0};
+        adopt();
+        const auto rings = active_.size();
+        tails_.resize(rings);
+        for (std::size_t index = 0; index < rings; ++index) {
+            auto& ring = *active_[(start_ + index) % rings];
+            auto tail = ring.tail.load(std::memory_order_relaxed);
+            const auto head = ring.head.load(std::memory_order_acquire);
+            while (tail < head && count < batch) {
+                const auto offset = std::size_t(tail & (capacity_ - 1));
+                uint32_t mark{0};
+                memcpy(&mark, ring.data.get() + offset, sizeof(mark));
+                if (mark & padding) {
+                    tail += mark & size_mask;
+                    continue;
+                }
+                const auto kind = (mark >> 26) & 7;
+                auto size = mark & size_mask;
+                const char *text = ring.data.get() + offset + unit;
+                tail += (units(size) + 1) * unit;
+                if (mark & binary) {
+                    decoded[count] = decode(text);
+                    text = decoded[count].data();
+                    size = uint32_t(std::min(decoded[count].size(), std::size_t(size_mask)));
+                }
+                records[count++] = {(mark & ~size_mask) | size, text};
+                if (mark & to_console) {
+                    auto prefix = label(kind);
+                    iov[lines++] = {const_cast<char *>(prefix.data()), prefix.size()};
+                    iov[lines++] = {const_cast<char *>(text), size};
+                    iov[lines++] = {const_cast<char *>("\n"), 1};
+                }
+            }
+            tails_[(start_ + index) % rings] = tail;
+        }
+        if (rings) start_ = (start_ + 1) % rings;
+        // each console record is three entries, and a partial one is lost
+        if (lines) {
+            const auto lost = output(iov, int(lines));
+            if (lost) unwritten_.fetch_add(uint64_t(lost + 2) / 3, std::memory_order_relaxed);
+        }
+        {
+            const std::lock_guard lock(notify_lock_);
+            for (std::size_t pos = 0; pos < count; ++pos) {
+                const auto size = records[pos].mark & size_mask;
+                const auto kind = (records[pos].mark >> 26) & 7;
+#ifdef USE_SYSLOG
+                constexpr int levels[] = {LOG_DEBUG, LOG_INFO, LOG_NOTICE, LOG_WARNING, LOG_ERR, LOG_CRIT, LOG_CRIT};
+                if (kind != debug)
+                    ::syslog(levels[kind], "%.*s", int(size), records[pos].text);
+#endif
+                try {
+                    notify_(std::string(records[pos].text, size), type(kind));
+                } catch (...) { // NOLINT
+                }
+            }
+        }
+        auto moved = false;
+        for (std::size_t index = 0; index < rings; ++index) {
+            auto& ring = *active_[index];
+            if (tails_[index] == ring.tail.load(std::memory_order_relaxed)) continue;
+            ring.tail.store(tails_[index], std::memory_order_release);
+            moved = true;
+        }
+        retire();
+        return moved;
+    }
+
+    static auto decode(const char *record) -> std::string {
+        decode_t decoder{nullptr};
+        uint32_t id{0};
+        memcpy(&decoder, record, sizeof(decoder));
+        memcpy(&id, record + sizeof(decoder), sizeof(id));
+        const auto fmt = detail::log_lookup(id);
+        if (!fmt) return "invalid log format id";
+        try {
+            return decoder(fmt, record + sizeof(decoder) + sizeof(id));
+        } catch (const std::exception& e) {
+            return std::string("invalid log format: ") + e.what();
+        }
+    }
+
+    void run() {
+        for (;;) {
+            if (drain()) continue;
+            if (stop_.load() && !pending()) return;
+            std::unique_lock lock(lock_);
+            idle_.store(true);
+            cond_.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                return stop_.load() || pending();
+            });
+            idle_.store(false);
+        }
+    }
+};
+
+// Static descriptor for one deferred record call site, made by TYCHO_RECORD.
+// The format is registered once for an id, so records carry only the id and
+// raw arguments and the writer looks the format up to format them. Deferred
+// records are info, notice, warn or error, and other kinds are refused when
+// constructed; debug levels and the exiting fail and crit kinds go through
+// the regular logger calls.
+class log_format final {
+public:
+    template <std::size_t N>
+    log_format(log_async::kind_t kind, const char (&fmt)[N]) : kind_(kind), fmt_(fmt) {
+        if (!deferred(kind)) throw std::invalid_argument("Records are info, notice, warn or error");
+        id_ = detail::log_enroll(fmt);
+    }
+
+    log_format(const log_format&) = delete;
+    auto operator=(const log_format&) -> auto& = delete;
+
+    static constexpr auto deferred(log_async::kind_t kind) noexcept {
+        return kind >= log_async::info && kind <= log_async::error;
+    }
+
+    static auto find(uint32_t id) -> const char * {
+        return detail::log_lookup(id);
+    }
+
+    auto kind() const noexcept {
+        return kind_;
+    }
+
+    auto format() const noexcept {
+        return fmt_;
+    }
+
+    auto id() const noexcept {
+        return id_;
+    }
+
+private:
+    log_async::kind_t kind_;
+    const char *fmt_;
+    uint32_t id_{0};
+};
+} // namespace tycho
+
 #if __cplusplus < 202002L
 #include <fmt/ranges.h>
 #include <fmt/format.h>
@@ -83,6 +685,16 @@ constexpr void println(FILE *fp, format_string<Args...> fmt, Args&&...args) {
     fprintf(fp, "%s\n", format(fmt, std::forward<Args>(args)...).c_str());
 }
 
+namespace detail {
+template <class... Args>
+auto log_vformat(const char *fmt, const Args&...args) -> std::string {
+    return fmt::vformat(fmt, fmt::make_format_args(args...));
+}
+} // namespace detail
+
+// compile time check of a record format against its arguments
+#define TYCHO_RECORD_CHECK(text, ...) fmt::format(FMT_STRING(text), ##__VA_ARGS__)
+
 template <class... Args>
 [[noreturn]] constexpr void die(int code, format_string<Args...> fmt, Args&&...args) {
     std::cerr << format(fmt, std::forward<Args>(args)...);
@@ -107,8 +719,13 @@ public:
     void debug(unsigned level, format_string<Args...> fmt, Args&&...args) {
 #ifndef NDEBUG
         if (level <= logging_) {
+            const detail::log_scope scope(active_);
             try {
                 auto msg = format(fmt, std::forward<Args>(args)...);
+                if (async_) {
+                    async_->push(log_async::debug, msg, true);
+                    return;
+                }
                 const std::lock_guard lock(locking_);
                 print(std::cerr, "debug: {}\n", msg);
                 notify_(msg, "debug");
@@ -122,7 +739,12 @@ public:
 
     template <class... Args>
     void info(format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::info, msg, logging_ > 1);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_INFO, "%s", msg.c_str());
@@ -134,7 +756,12 @@ public:
 
     template <class... Args>
     void notice(format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::notice, msg, logging_ > 0);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_NOTICE, "%s", msg.c_str());
@@ -146,7 +773,12 @@ public:
 
     template <class... Args>
     void warn(format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::warn, msg, logging_ != 0);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_WARNING, "%s", msg.c_str());
@@ -158,7 +790,12 @@ public:
 
     template <class... Args>
     void error(format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::error, msg, logging_ != 0);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_ERR, "%s", msg.c_str());
@@ -170,7 +807,13 @@ public:
 
     template <class... Args>
     [[noreturn]] void fail(int exit_code, format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::fail, msg, logging_ != 0, true);
+            async_->flush();
+            ::exit(exit_code);
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_CRIT, "%s", msg.c_str());
@@ -184,7 +827,13 @@ public:
 
     template <class... Args>
     [[noreturn]] void crit(int exit_code, format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::crit, msg, logging_ != 0, true);
+            async_->flush();
+            quick_exit(exit_code);
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_CRIT, "%s", msg.c_str());
@@ -196,9 +845,11 @@ public:
         quick_exit(exit_code);
     }
 
-    void set(unsigned level, notify_t notify) noexcept {
+    void set(unsigned level, notify_t notify) {
+        const std::lock_guard lock(locking_);
         logging_ = level;
         notify_ = notify;
+        if (async_) async_->notify(std::move(notify));
     }
 
     void set(unsigned level) noexcept {
@@ -206,13 +857,59 @@ public:
     }
 
     auto level() const noexcept {
-        return logging_;
+        return logging_.load();
     }
 
     void level(unsigned l) noexcept {
         logging_ = l;
     }
 
+    // Hand output to a background writer with a ring of capacity bytes for
+    // each logging thread. Logging threads read the backend without locking,
+    // so switch modes only while no other thread logs.
+    void async(std::size_t capacity = 1 << 16, log_policy policy = log_policy::drop, int fd = 2) {
+        assert(active_.load() == 0);
+        async_.reset();
+        async_ = std::make_unique<log_async>(notify_, capacity, policy, fd);
+    }
+
+    // drain and return to logging on the caller thread
+    void sync() noexcept {
+        assert(active_.load() == 0);
+        async_.reset();
+    }
+
+    void flush() noexcept {
+        if (async_) async_->flush();
+    }
+
+    auto dropped() const noexcept -> uint64_t {
+        return async_ ? async_->dropped() : 0;
+    }
+
+    // Deferred record from a TYCHO_RECORD call site; in async mode only the
+    // format id and argument bytes are queued for the writer to format.
+    template <class... Args>
+    void record(const log_format& site, const Args&...args) {
+        const detail::log_scope scope(active_);
+        const auto kind = site.kind();
+        const auto console = (kind == log_async::info) ? logging_ > 1 : (kind == log_async::notice) ? logging_ > 0 : logging_ != 0;
+        if (async_) {
+            async_->write(kind, console, site.id(), args...);
+            return;
+        }
+
+        auto msg = detail::log_vformat(site.format(), args...);
+        const std::lock_guard lock(locking_);
+#ifdef USE_SYSLOG
+        constexpr int levels[] = {LOG_DEBUG, LOG_INFO, LOG_NOTICE, LOG_WARNING, LOG_ERR};
+        ::syslog(levels[kind], "%s", msg.c_str());
+#endif
+        notify_(msg, log_async::type(kind));
+        if (console)
+            std::cerr << log_async::label(kind) << msg << '\n';
+    }
+
 #ifdef USE_SYSLOG
     static void open(const char *id, int level = LOG_INFO, int facility = LOG_DAEMON, int flags = LOG_CONS | LOG_NDELAY) {
         ::openlog(id, flags, facility);
@@ -229,8 +926,10 @@ public:
 
 private:
     std::mutex locking_;
-    unsigned logging_{1};
+    std::atomic<unsigned> logging_{1};
     notify_t notify_{[](const std::string& str, const char *type) {}};
+    std::unique_ptr<log_async> async_;
+    std::atomic<unsigned> active_{0};
 };
 
 // cppcheck-suppress constParameterPointer
@@ -278,6 +977,16 @@ void print(FILE *fp, const char *fmt, Args&&...args) {
     bound);
 }
 
+namespace detail {
+template <class... Args>
+auto log_vformat(const char *fmt, const Args&...args) -> std::string {
+    return std::vformat(fmt, std::make_format_args(args...));
+}
+} // namespace detail
+
+// compile time check of a record format against its arguments
+#define TYCHO_RECORD_CHECK(text, ...) std::format(text, ##__VA_ARGS__)
+
 template <class... Args>
 [[noreturn]] constexpr void die(int code, std::format_string<Args...> fmt, Args&&...args) {
     std::cerr << std::format(fmt, std::forward<Args>(args)...);
@@ -302,8 +1011,13 @@ public:
     void debug(unsigned level, std::format_string<Args...> fmt, Args&&...args) {
 #ifndef NDEBUG
         if (level <= logging_) {
+            const detail::log_scope scope(active_);
             try {
                 auto msg = std::format(fmt, std::forward<Args>(args)...);
+                if (async_) {
+                    async_->push(log_async::debug, msg, true);
+                    return;
+                }
                 const std::lock_guard lock(locking_);
                 std::cerr << std::format("debug: {}\n", msg);
                 notify_(msg, "debug");
@@ -317,7 +1031,12 @@ public:
 
     template <class... Args>
     void info(std::format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = std::format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::info, msg, logging_ > 1);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_INFO, "%s", msg.c_str());
@@ -329,7 +1048,12 @@ public:
 
     template <class... Args>
     void notice(std::format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = std::format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::notice, msg, logging_ > 0);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_NOTICE, "%s", msg.c_str());
@@ -341,7 +1065,12 @@ public:
 
     template <class... Args>
     void warn(std::format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = std::format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::warn, msg, logging_ != 0);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_WARNING, "%s", msg.c_str());
@@ -353,7 +1082,12 @@ public:
 
     template <class... Args>
     void error(std::format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = std::format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::error, msg, logging_ != 0);
+            return;
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_ERR, "%s", msg.c_str());
@@ -365,7 +1099,13 @@ public:
 
     template <class... Args>
     [[noreturn]] void fail(int exit_code, std::format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = std::format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::fail, msg, logging_ != 0, true);
+            async_->flush();
+            ::exit(exit_code);
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_CRIT, "%s", msg.c_str());
@@ -379,7 +1119,13 @@ public:
 
     template <class... Args>
     [[noreturn]] void crit(int exit_code, std::format_string<Args...> fmt, Args&&...args) {
+        const detail::log_scope scope(active_);
         auto msg = std::format(fmt, std::forward<Args>(args)...);
+        if (async_) {
+            async_->push(log_async::crit, msg, logging_ != 0, true);
+            async_->flush();
+            quick_exit(exit_code);
+        }
         const std::lock_guard lock(locking_);
 #ifdef USE_SYSLOG
         ::syslog(LOG_CRIT, "%s", msg.c_str());
@@ -391,9 +1137,11 @@ public:
         quick_exit(exit_code);
     }
 
-    void set(unsigned level, notify_t notify = [](const std::string& str, const char *type) {}) noexcept {
+    void set(unsigned level, notify_t notify = [](const std::string& str, const char *type) {}) {
+        const std::lock_guard lock(locking_);
         logging_ = level;
         notify_ = notify;
+        if (async_) async_->notify(std::move(notify));
     }
 
     void set(unsigned level) noexcept {
@@ -401,13 +1149,59 @@ public:
     }
 
     auto level() const noexcept {
-        return logging_;
+        return logging_.load();
     }
 
     void level(unsigned l) noexcept {
         logging_ = l;
     }
 
+    // Hand output to a background writer with a ring of capacity bytes for
+    // each logging thread. Logging threads read the backend without locking,
+    // so switch modes only while no other thread logs.
+    void async(std::size_t capacity = 1 << 16, log_policy policy = log_policy::drop, int fd = 2) {
+        assert(active_.load() == 0);
+        async_.reset();
+        async_ = std::make_unique<log_async>(notify_, capacity, policy, fd);
+    }
+
+    // drain and return to logging on the caller thread
+    void sync() noexcept {
+        assert(active_.load() == 0);
+        async_.reset();
+    }
+
+    void flush() noexcept {
+        if (async_) async_->flush();
+    }
+
+    auto dropped() const noexcept -> uint64_t {
+        return async_ ? async_->dropped() : 0;
+    }
+
+    // Deferred record from a TYCHO_RECORD call site; in async mode only the
+    // format id and argument bytes are queued for the writer to format.
+    template <class... Args>
+    void record(const log_format& site, const Args&...args) {
+        const detail::log_scope scope(active_);
+        const auto kind = site.kind();
+        const auto console = (kind == log_async::info) ? logging_ > 1 : (kind == log_async::notice) ? logging_ > 0 : logging_ != 0;
+        if (async_) {
+            async_->write(kind, console, site.id(), args...);
+            return;
+        }
+
+        auto msg = detail::log_vformat(site.format(), args...);
+        const std::lock_guard lock(locking_);
+#ifdef USE_SYSLOG
+        constexpr int levels[] = {LOG_DEBUG, LOG_INFO, LOG_NOTICE, LOG_WARNING, LOG_ERR};
+        ::syslog(levels[kind], "%s", msg.c_str());
+#endif
+        notify_(msg, log_async::type(kind));
+        if (console)
+            std::cerr << log_async::label(kind) << msg << '\n';
+    }
+
 #ifdef USE_SYSLOG
     static void open(const char *id, int level = LOG_INFO, int facility = LOG_DAEMON, int flags = LOG_CONS | LOG_NDELAY) {
         ::openlog(id, flags, facility);
@@ -424,8 +1218,10 @@ public:
 
 private:
     std::mutex locking_;
-    unsigned logging_{1};
+    std::atomic<unsigned> logging_{1};
     notify_t notify_{[](const std::string& str, const char *type) {}};
+    std::unique_ptr<log_async> async_;
+    std::atomic<unsigned> active_{0};
 };
 
 // cppcheck-suppress constParameterPointer
@@ -435,4 +1231,15 @@ inline auto on_crit(void (*handler)()) {
 } // namespace tycho
 
 #endif
+
+// Deferred record for hot paths. The format must be a string literal; it is
+// checked against the arguments at compile time and registered once per call
+// site, and arguments are not evaluated by the check.
+#define TYCHO_RECORD(logger, kind, text, ...)                                                        \
+    do {                                                                                             \
+        static_assert(tycho::log_format::deferred(kind), "Records are info, notice, warn or error"); \
+        if (false) (void)TYCHO_RECORD_CHECK(text, ##__VA_ARGS__);                                    \
+        static const tycho::log_format tycho_record_site_(kind, "" text);                            \
+        (logger).record(tycho_record_site_, ##__VA_ARGS__);                                          \
+    } while (false)
 #endif
@@ -12,8 +12,16 @@
 #include <utility>
 #include <cstring>
 #include <memory>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <openssl/rand.h>
 
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
 namespace tycho::crypto {
 using key_t = std::pair<const uint8_t *, std::size_t>;
 
@@ -27,16 +35,90 @@ inline constexpr auto sha512_key = 512UL;
 inline constexpr auto aes128_key = 128UL;
 inline constexpr auto aes256_key = 256UL;
 
+// Per-thread buffer of RAND_bytes output so small requests avoid a trip
+// into the openssl drbg each time. Used bytes are wiped, and the buffer is
+// discarded if the process forks, which an atfork hook counts so each draw
+// only compares a generation rather than calling getpid.
+class random_pool final {
+public:
+    static constexpr std::size_t pool_size = 4096;
+
+    random_pool(const random_pool&) = delete;
+    auto operator=(const random_pool&) -> random_pool& = delete;
+
+    ~random_pool() {
+        memset(data_, 0, sizeof(data_));
+    }
+
+    static auto get() -> random_pool& {
+        thread_local random_pool pool;
+        return pool;
+    }
+
+    auto fill(uint8_t *out, std::size_t size) -> bool {
+        if (!out) return false;
+        if (size >= pool_size / 2) return ::RAND_bytes(out, int(size)) == 1;
+        check_fork();
+        while (size) {
+            if (pos_ >= pool_size && !refill()) return false;
+            auto count = std::min(size, pool_size - pos_);
+            memcpy(out, data_ + pos_, count);
+            memset(data_ + pos_, 0, count);
+            pos_ += count;
+            out += count;
+            size -= count;
+        }
+        return true;
+    }
+
+    void clear() noexcept {
+        memset(data_, 0, sizeof(data_));
+        pos_ = pool_size;
+    }
+
+private:
+    uint8_t data_[pool_size]{0};
+    std::size_t pos_{pool_size};
+    unsigned generation_{0};
+
+    static inline std::atomic<unsigned> forks_{0};
+
+    random_pool() noexcept {
+#ifndef _WIN32
+        static const auto hooked = ::pthread_atfork(nullptr, nullptr, &random_pool::forked) == 0;
+        static_cast<void>(hooked);
+#endif
+        generation_ = forks_.load(std::memory_order_relaxed);
+    }
+
+    static void forked() noexcept {
+        forks_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto refill() -> bool {
+        if (::RAND_bytes(data_, int(pool_size)) != 1) return false;
+        pos_ = 0;
+        return true;
+    }
+
+    void check_fork() noexcept {
+        const auto generation = forks_.load(std::memory_order_relaxed);
+        if (generation == generation_) return;
+        generation_ = generation;
+        clear();
+    }
+};
+
 template <typename T>
 inline void rand(T& data) {
     static_assert(std::is_trivial_v<T>, "T must be Trivial type");
 
     auto ptr = reinterpret_cast<uint8_t *>(&data);
-    ::RAND_bytes(ptr, int(sizeof(data)));
+    random_pool::get().fill(ptr, sizeof(data));
 }
 
 inline void rand(uint8_t *ptr, std::size_t size) {
-    ::RAND_bytes(ptr, int(size));
+    random_pool::get().fill(ptr, size);
 }
 
 template <typename T>
@@ -51,11 +133,159 @@ inline void zero(uint8_t *ptr, std::size_t size) {
     memset(ptr, 0, size);
 }
 
+// Fast xoshiro256** generator for simulation and jitter, not for keys.
+// Satisfies UniformRandomBitGenerator so it works with std distributions.
+class xoshiro_t final {
+public:
+    using result_type = uint64_t;
+
+    xoshiro_t() {
+        uint64_t seed{0};
+        rand(seed);
+        reseed(seed);
+    }
+
+    explicit xoshiro_t(uint64_t seed) noexcept {
+        reseed(seed);
+    }
+
+    static constexpr auto min() noexcept -> result_type {
+        return 0;
+    }
+
+    static constexpr auto max() noexcept -> result_type {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    void reseed(uint64_t seed) noexcept {
+        for (auto& word : state_) {
+            // splitmix64 expands the seed
+            seed += 0x9e3779b97f4a7c15ULL;
+            auto z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    auto operator()() noexcept -> result_type {
+        const auto result = rotl(state_[1] * 5, 7) * 9;
+        const auto t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    // advance 2^128 calls, for non-overlapping parallel streams
+    void jump() noexcept {
+        static constexpr uint64_t table[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+        uint64_t s[4] = {0, 0, 0, 0};
+        for (auto mask : table) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (mask & (uint64_t(1) << bit)) {
+                    for (int pos = 0; pos < 4; ++pos)
+                        s[pos] ^= state_[pos];
+                }
+                (*this)();
+            }
+        }
+        for (int pos = 0; pos < 4; ++pos)
+            state_[pos] = s[pos];
+    }
+
+private:
+    uint64_t state_[4]{0};
+
+    static constexpr auto rotl(uint64_t x, int k) noexcept -> uint64_t {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+// Per-thread fast generator, seeded once from the csprng.
+inline auto fast_random() -> xoshiro_t& {
+    thread_local xoshiro_t gen;
+    return gen;
+}
+
+// Unbiased value in [0, bound) using Lemire's multiply and reject method.
+template <typename Gen>
+inline auto bounded(Gen& gen, uint64_t bound) -> uint64_t {
+    static_assert(Gen::min() == 0 && Gen::max() == std::numeric_limits<uint64_t>::max(), "Gen must produce 64 bit values");
+    if (bound < 2) return 0;
+#if defined(__SIZEOF_INT128__)
+    auto product = static_cast<unsigned __int128>(gen()) * bound;
+    auto low = static_cast<uint64_t>(product);
+    if (low < bound) {
+        const auto threshold = (0 - bound) % bound;
+        while (low < threshold) {
+            product = static_cast<unsigned __int128>(gen()) * bound;
+            low = static_cast<uint64_t>(product);
+        }
+    }
+    return static_cast<uint64_t>(product >> 64);
+#else
+    const auto threshold = (0 - bound) % bound;
+    for (;;) {
+        auto value = gen();
+        if (value >= threshold) return value % bound;
+    }
+#endif
+}
+
+template <typename Gen>
+inline void fill(Gen& gen, uint8_t *out, std::size_t size) {
+    while (size >= sizeof(uint64_t)) {
+        auto value = static_cast<uint64_t>(gen());
+        memcpy(out, &value, sizeof(value));
+        out += sizeof(value);
+        size -= sizeof(value);
+    }
+    if (size) {
+        auto value = static_cast<uint64_t>(gen());
+        memcpy(out, &value, size);
+    }
+}
+
+// Adapts the buffered csprng to the generator interface.
+struct secure_random final {
+    using result_type = uint64_t;
+
+    static constexpr auto min() noexcept -> result_type {
+        return 0;
+    }
+
+    static constexpr auto max() noexcept -> result_type {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    auto operator()() const -> result_type {
+        result_type value{0};
+        rand(value);
+        return value;
+    }
+};
+
+inline auto secure_range(uint64_t bound) {
+    secure_random gen;
+    return bounded(gen, bound);
+}
+
+inline auto fast_range(uint64_t bound) {
+    return bounded(fast_random(), bound);
+}
+
+inline void fast_fill(uint8_t *out, std::size_t size) {
+    fill(fast_random(), out, size);
+}
+
 inline auto random_dist(int min, int max) {
-    std::random_device rd;
-    std::mt19937 rand_gen(rd());
-    std::uniform_int_distribution<> dist(min, max);
-    return dist(rand_gen);
+    if (max <= min) return min;
+    auto span = uint64_t(int64_t(max) - int64_t(min)) + 1;
+    return int(int64_t(min) + int64_t(bounded(fast_random(), span)));
 }
 
 inline auto make_key(const uint8_t *data, std::size_t size) -> key_t {
@@ -0,0 +1,481 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#ifndef TYCHO_RECORDS_HPP_
+#define TYCHO_RECORDS_HPP_
+
+#include "scan.hpp"
+#include "tasks.hpp"
+#include "filesystem.hpp"
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+
+namespace tycho {
+enum class field_t : uint8_t { skip = 0, integer, real, text, duration };
+
+namespace detail {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+inline auto record_match64(const char *text, char code) noexcept -> uint64_t {
+    const auto find = _mm_set1_epi8(code);
+    uint64_t mask{0};
+    for (unsigned pos = 0; pos < 64; pos += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + pos));
+        mask |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(block, find)))) << pos;
+    }
+    return mask;
+}
+#else
+inline auto record_match64(const char *text, char code) noexcept -> uint64_t {
+    uint64_t mask{0};
+    for (unsigned pos = 0; pos < 64; ++pos)
+        mask |= uint64_t(text[pos] == code) << pos;
+    return mask;
+}
+#endif
+
+// bit i set when an odd number of quotes are at or before i
+constexpr auto record_inside(uint64_t quotes) noexcept {
+    quotes ^= quotes << 1;
+    quotes ^= quotes << 2;
+    quotes ^= quotes << 4;
+    quotes ^= quotes << 8;
+    quotes ^= quotes << 16;
+    quotes ^= quotes << 32;
+    return quotes;
+}
+
+inline auto record_count(uint64_t mask) noexcept {
+    return unsigned(__builtin_popcountll(mask));
+}
+
+inline auto record_first(uint64_t mask) noexcept {
+    return unsigned(__builtin_ctzll(mask));
+}
+} // namespace detail
+
+// One batch of rows stored column by column; text views refer to the
+// parsed input or to batch storage and are valid while the batch lives.
+class record_batch final {
+public:
+    record_batch(const record_batch&) = delete;
+    auto operator=(const record_batch&) -> auto& = delete;
+
+    explicit record_batch(const std::vector<field_t>& types, std::size_t limit) : types_(types), columns_(types.size()), limit_(limit) {
+        for (std::size_t col = 0; col < types_.size(); ++col)
+            reserve(col);
+    }
+
+    explicit operator bool() const noexcept {
+        return rows_ > 0;
+    }
+
+    auto operator!() const noexcept {
+        return rows_ == 0;
+    }
+
+    auto rows() const noexcept {
+        return rows_;
+    }
+
+    auto columns() const noexcept {
+        return types_.size();
+    }
+
+    // input chunk and first row of this batch within that chunk
+    auto chunk() const noexcept {
+        return chunk_;
+    }
+
+    auto first() const noexcept {
+        return first_;
+    }
+
+    auto type(std::size_t col) const {
+        return types_.at(col);
+    }
+
+    auto integers(std::size_t col) const -> const std::vector<int64_t>& {
+        return columns_.at(col).integers;
+    }
+
+    auto reals(std::size_t col) const -> const std::vector<double>& {
+        return columns_.at(col).reals;
+    }
+
+    auto texts(std::size_t col) const -> const std::vector<std::string_view>& {
+        return columns_.at(col).texts;
+    }
+
+    auto durations(std::size_t col) const -> const std::vector<unsigned>& {
+        return columns_.at(col).durations;
+    }
+
+    // non-zero when the field was present and converted
+    auto valid(std::size_t col) const -> const std::vector<uint8_t>& {
+        return columns_.at(col).valid;
+    }
+
+    auto errors() const noexcept {
+        return errors_;
+    }
+
+private:
+    friend class record_parser;
+
+    struct column_t {
+        std::vector<int64_t> integers;
+        std::vector<double> reals;
+        std::vector<std::string_view> texts;
+        std::vector<unsigned> durations;
+        std::vector<uint8_t> valid;
+    };
+
+    const std::vector<field_t>& types_;
+    std::vector<column_t> columns_;
+    std::deque<std::string> unescaped_;
+    std::size_t limit_{0}, rows_{0}, chunk_{0}, first_{0}, errors_{0};
+
+    void reserve(std::size_t col) {
+        auto& column = columns_[col];
+        column.valid.reserve(limit_);
+        switch (types_[col]) {
+        case field_t::integer:
+            column.integers.reserve(limit_);
+            break;
+        case field_t::real:
+            column.reals.reserve(limit_);
+            break;
+        case field_t::text:
+            column.texts.reserve(limit_);
+            break;
+        case field_t::duration:
+            column.durations.reserve(limit_);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void reset(std::size_t chunk, std::size_t first) noexcept {
+        for (auto& column : columns_) {
+            column.integers.clear();
+            column.reals.clear();
+            column.texts.clear();
+            column.durations.clear();
+            column.valid.clear();
+        }
+        unescaped_.clear();
+        rows_ = errors_ = 0;
+        chunk_ = chunk;
+        first_ = first;
+    }
+
+    void store(std::size_t col, std::string_view field, char escape) {
+        auto& column = columns_[col];
+        bool valid = true;
+        switch (types_[col]) {
+        case field_t::integer: {
+            int64_t value{0};
+            valid = to_integer(field, value);
+            column.integers.push_back(value);
+            break;
+        }
+        case field_t::real: {
+            double value{0.0};
+            valid = to_real(field, value);
+            column.reals.push_back(value);
+            break;
+        }
+        case field_t::duration: {
+            unsigned value{0};
+            valid = to_duration(field, value);
+            column.durations.push_back(value);
+            break;
+        }
+        case field_t::text:
+            if (escape)
+                field = unescape(field, escape);
+            column.texts.push_back(field);
+            break;
+        default:
+            break;
+        }
+        if (!valid) ++errors_;
+        column.valid.push_back(valid);
+    }
+
+    // fill columns a short row did not reach
+    void finish(std::size_t col) {
+        for (; col < columns_.size(); ++col) {
+            auto& column = columns_[col];
+            switch (types_[col]) {
+            case field_t::integer:
+                column.integers.push_back(0);
+                break;
+            case field_t::real:
+                column.reals.push_back(0.0);
+                break;
+            case field_t::text:
+                column.texts.emplace_back();
+                break;
+            case field_t::duration:
+                column.durations.push_back(0);
+                break;
+            default:
+                break;
+            }
+            column.valid.push_back(0);
+        }
+        ++rows_;
+    }
+
+    auto unescape(std::string_view field, char quote) -> std::string_view {
+        auto& text = unescaped_.emplace_back();
+        text.reserve(field.size());
+        for (std::size_t pos = 0; pos < field.size(); ++pos) {
+            text += field[pos];
+            if (field[pos] == quote && pos + 1 < field.size() && field[pos + 1] == quote) ++pos;
+        }
+        return text;
+    }
+
+    static auto to_integer(std::string_view text, int64_t& out) -> bool {
+        auto neg = !text.empty() && text.front() == '-';
+        if (!text.empty() && (text.front() == '-' || text.front() == '+'))
+            text.remove_prefix(1);
+        if (text.empty() || !isdigit(text.front())) return false;
+        const uint64_t limit = neg ? uint64_t(std::numeric_limits<int64_t>::max()) + 1 : uint64_t(std::numeric_limits<int64_t>::max());
+        auto value = scan::value(text, limit);
+        if (!text.empty()) return false;
+        out = neg ? -int64_t(value - 1) - 1 : int64_t(value);
+        return true;
+    }
+
+    static auto to_real(std::string_view text, double& out) -> bool {
+        auto neg = !text.empty() && text.front() == '-';
+        if (!text.empty() && (text.front() == '-' || text.front() == '+'))
+            text.remove_prefix(1);
+        if (text.empty() || (!isdigit(text.front()) && text.front() != '.')) return false;
+        auto value = scan::real(text, UINT64_MAX);
+        if (!text.empty()) return false;
+        out = neg ? -value : value;
+        return true;
+    }
+
+    static auto to_duration(std::string_view text, unsigned& out) -> bool {
+        try {
+            out = get_duration(text);
+            return true;
+        } catch (const std::exception& e) {
+            return false;
+        }
+    }
+};
+
+// Delimited record parser that writes typed columns in row batches. Quoted
+// fields may hold delimiters, newlines, and doubled quotes. Large input is
+// split into chunks on record boundaries and parsed across a task pool.
+class record_parser final {
+public:
+    explicit record_parser(std::vector<field_t> types, char delim = ',', std::size_t batch = 4096, char quote = '\"') : types_(std::move(types)), batch_(batch), delim_(delim), quote_(quote) {
+        if (types_.empty()) throw std::invalid_argument("Records need columns");
+        if (!batch_) throw std::invalid_argument("Record batch empty");
+        if (delim_ == quote_ || delim_ == '\n' || quote_ == '\n') throw std::invalid_argument("Record delimiter invalid");
+    }
+
+    auto columns() const noexcept {
+        return types_.size();
+    }
+
+    // first record of the input is a header line to skip
+    void header(bool skip = true) noexcept {
+        header_ = skip;
+    }
+
+    // smallest span of input given to one parallel task
+    void chunk_size(std::size_t size) noexcept {
+        chunk_ = size ? size : 1;
+    }
+
+    template <typename Func>
+    auto parse(std::string_view data, Func func) const -> std::size_t {
+        return parse_range(data, 0, 0, data.size(), header_, func);
+    }
+
+    // func may be called from several pool workers at once
+    template <typename Func>
+    auto parse(task_pool& pool, std::string_view data, Func func) const -> std::size_t {
+        auto count = std::min(std::max(pool.size(), std::size_t(1)) * 4, data.size() / chunk_);
+        if (count < 2) return parse(data, func);
+
+        std::vector<std::size_t> starts(count + 1), quotes(count);
+        for (std::size_t index = 0; index < count; ++index)
+            starts[index] = data.size() / count * index;
+        starts[count] = data.size();
+        parallel_for(pool, count, [&](std::size_t index) {
+            quotes[index] = count_quotes(data, starts[index], starts[index + 1]);
+            return true;
+        });
+
+        // quote parity before each raw split finds where its records begin
+        std::size_t parity{0};
+        std::vector<std::size_t> begins(count + 1, data.size());
+        begins[0] = 0;
+        for (std::size_t index = 1; index < count; ++index) {
+            parity += quotes[index - 1];
+            begins[index] = next_record(data, starts[index], (parity & 1) != 0);
+        }
+
+        std::atomic<std::size_t> rows{0};
+        parallel_for(pool, count, [&](std::size_t index) {
+            auto from = std::min(begins[index], data.size());
+            auto to = std::max(from, std::min(begins[index + 1], data.size()));
+            rows += parse_range(data, index, from, to, header_ && !index, func);
+            return true;
+        });
+        return rows.load();
+    }
+
+    template <typename Func>
+    auto parse_file(const fsys::path& path, Func func) const -> std::size_t {
+        return map_file(path, [&](std::string_view data) { return parse(data, func); });
+    }
+
+    template <typename Func>
+    auto parse_file(task_pool& pool, const fsys::path& path, Func func) const -> std::size_t {
+        return map_file(path, [&](std::string_view data) { return parse(pool, data, func); });
+    }
+
+private:
+    std::vector<field_t> types_;
+    std::size_t batch_{4096}, chunk_{std::size_t(1) << 20};
+    char delim_{','}, quote_{'\"'};
+    bool header_{false};
+
+    template <typename Parse>
+    static auto map_file(const fsys::path& path, Parse parse) -> std::size_t {
+        auto size = std::size_t(fsys::file_size(path));
+        if (!size) return 0;
+        auto fd = fsys::open_shared(path);
+        if (fd < 0) throw std::runtime_error("Cannot open records");
+        auto addr = fsys::map(fd, size);
+        fsys::close(fd);
+        if (!addr) throw std::runtime_error("Cannot map records");
+        try {
+            auto rows = parse(std::string_view(static_cast<const char *>(addr), size));
+            fsys::unmap(addr, size);
+            return rows;
+        } catch (...) {
+            fsys::unmap(addr, size);
+            throw;
+        }
+    }
+
+    // masks for 64 bytes at pos; bytes past the end are padded with zero
+    void block(std::string_view data, std::size_t pos, uint64_t& quotes, uint64_t& delims, uint64_t& lines) const noexcept {
+        const char *text = data.data() + pos;
+        char tail[64];
+        if (data.size() - pos < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, text, data.size() - pos);
+            text = tail;
+        }
+        quotes = detail::record_match64(text, quote_);
+        delims = detail::record_match64(text, delim_);
+        lines = detail::record_match64(text, '\n');
+    }
+
+    auto count_quotes(std::string_view data, std::size_t from, std::size_t to) const noexcept -> std::size_t {
+        std::size_t count{0};
+        uint64_t quotes{0}, delims{0}, lines{0};
+        for (auto pos = from; pos < to; pos += 64) {
+            block(data, pos, quotes, delims, lines);
+            if (to - pos < 64)
+                quotes &= (uint64_t(1) << (to - pos)) - 1;
+            count += detail::record_count(quotes);
+        }
+        return count;
+    }
+
+    auto next_record(std::string_view data, std::size_t pos, bool inside) const noexcept -> std::size_t {
+        uint64_t quotes{0}, delims{0}, lines{0};
+        for (; pos < data.size(); pos += 64) {
+            block(data, pos, quotes, delims, lines);
+            auto quoted = detail::record_inside(quotes) ^ (inside ? ~uint64_t(0) : 0);
+            lines &= ~quoted;
+            if (lines) return pos + detail::record_first(lines) + 1;
+            inside = (quoted >> 63) != 0;
+        }
+        return data.size();
+    }
+
+    template <typename Func>
+    auto parse_range(std::string_view data, std::size_t chunk, std::size_t from, std::size_t to, bool skip, Func& func) const -> std::size_t {
+        record_batch batch(types_, batch_);
+        std::size_t rows{0}, col{0}, field{from};
+        bool inside{false};
+        batch.reset(chunk, 0);
+
+        auto emit = [&](std::size_t end, bool line) {
+            if (line && end > field && data[end - 1] == '\r') --end;
+            if (line && !col && end == field) return; // blank line
+            if (!skip && col < types_.size()) {
+                auto text = data.substr(field, end - field);
+                char escape = 0;
+                if (text.size() > 1 && text.front() == quote_ && text.back() == quote_) {
+                    text = text.substr(1, text.size() - 2);
+                    if (text.find(quote_) != std::string_view::npos) escape = quote_;
+                }
+                batch.store(col, text, escape);
+            }
+            ++col;
+            if (!line) return;
+            if (!skip) {
+                batch.finish(std::min(col, types_.size()));
+                ++rows;
+                if (batch.rows() >= batch_) {
+                    func(static_cast<const record_batch&>(batch));
+                    batch.reset(chunk, rows);
+                }
+            }
+            skip = false;
+            col = 0;
+        };
+
+        uint64_t quotes{0}, delims{0}, lines{0};
+        for (auto pos = from; pos < to; pos += 64) {
+            block(data, pos, quotes, delims, lines);
+            auto quoted = detail::record_inside(quotes) ^ (inside ? ~uint64_t(0) : 0);
+            auto marks = (delims | lines) & ~quoted;
+            if (to - pos < 64)
+                marks &= (uint64_t(1) << (to - pos)) - 1;
+            inside = (quoted >> 63) != 0;
+            while (marks) {
+                auto bit = detail::record_first(marks);
+                marks &= marks - 1;
+                auto end = pos + bit;
+                emit(end, ((lines >> bit) & 1) != 0);
+                field = end + 1;
+            }
+        }
+        if (field < to || col)
+            emit(to, true);
+        if (batch)
+            func(static_cast<const record_batch&>(batch));
+        return rows;
+    }
+};
+} // namespace tycho
+#endif
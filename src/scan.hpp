@@ -4,6 +4,8 @@
 #ifndef TYCHO_SCAN_HPP_
 #define TYCHO_SCAN_HPP_
 
+#include "endian.hpp"
+
 #include <string_view>
 #include <string>
 #include <stdexcept>
@@ -11,11 +13,84 @@
 #include <cstdint>
 #include <cctype>
 #include <cmath>
+#include <cstdlib>
+#include <array>
+#include <charconv>
+#include <algorithm>
 
 // low level utility scan functions
 namespace tycho::scan {
 constexpr std::string_view hex_digits("0123456789abcdef");
 
+namespace detail {
+constexpr auto make_hex_values() {
+    std::array<uint8_t, 256> table{};
+    for (auto& entry : table)
+        entry = 0xff;
+    for (uint8_t pos = 0; pos < 10; ++pos)
+        table[uint8_t('0' + pos)] = pos;
+    for (uint8_t pos = 0; pos < 6; ++pos) {
+        table[uint8_t('a' + pos)] = uint8_t(10 + pos);
+        table[uint8_t('A' + pos)] = uint8_t(10 + pos);
+    }
+    return table;
+}
+
+inline constexpr auto hex_values = make_hex_values();
+
+inline constexpr double exact_powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// eight ascii digits at once; false if any byte is not a digit
+inline auto swar_digits(const char *text, uint64_t& out) noexcept {
+    auto val = le_get64(reinterpret_cast<const uint8_t *>(text));
+    if (((val & 0xf0f0f0f0f0f0f0f0ULL) | (((val + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) >> 4)) != 0x3333333333333333ULL) return false;
+    val -= 0x3030303030303030ULL;
+    val = (val * 10) + (val >> 8);
+    out = (((val & 0x000000ff000000ffULL) * (100 + (1000000ULL << 32))) + (((val >> 16) & 0x000000ff000000ffULL) * (1 + (10000ULL << 32)))) >> 32;
+    return true;
+}
+
+// A decimal number gathered in one pass: the integer part bounded like
+// value(), up to 19 significant digits, and the power of ten to apply.
+struct decimal_t final {
+    uint64_t integer{0};
+    uint64_t mantissa{0};
+    int digits{0};
+    int scale{0};
+    bool whole{true};
+};
+
+constexpr auto is_digit(char ch) noexcept {
+    return unsigned(ch - '0') < 10U;
+}
+
+// correctly rounded from_chars (Eisel-Lemire in libstdc++) of the text,
+// kept out of line so the fast path below stays small enough to inline
+__attribute__((noinline, cold)) inline auto from_text(const char *from, const char *to, const decimal_t& num, double or_else) -> double {
+    double result{or_else};
+#if defined(__cpp_lib_to_chars)
+    auto status = std::from_chars(from, to, result).ec;
+    if (status == std::errc::result_out_of_range) return num.scale + num.digits > 0 ? HUGE_VAL : 0.0;
+    if (status != std::errc()) return or_else;
+#else
+    const std::string copy(from, to);
+    char *end{nullptr};
+    result = std::strtod(copy.c_str(), &end);
+    if (end != copy.c_str() + copy.size()) return or_else;
+#endif
+    return result;
+}
+
+// Clinger fast path when the digits and power of ten are both exact
+inline auto to_double(const char *from, const char *to, const decimal_t& num, double or_else) -> double {
+    if (!num.digits) return 0.0;
+    if (num.digits > 19 || num.mantissa > (1ULL << 53) || num.scale < -22 || num.scale > 22)
+        return from_text(from, to, num, or_else);
+    if (num.scale < 0) return double(num.mantissa) / exact_powers[-num.scale];
+    return double(num.mantissa) * exact_powers[num.scale];
+}
+} // namespace detail
+
 inline auto count(const std::string_view& text, char code) {
     std::size_t count = 0;
     for (const char ch : text) {
@@ -41,12 +116,12 @@ inline auto pow(long base, long exp) {
 inline auto hex(std::string_view& text, unsigned digits = 8) -> uint64_t {
     uint64_t val = 0;
 
-    if (digits > 8) return val;
+    if (digits > 16) return val;
     while (digits-- && !text.empty()) {
-        auto pos = hex_digits.find(char(tolower(text.front())));
-        if (pos > 15) return val;
+        auto nibble = detail::hex_values[uint8_t(text.front())];
+        if (nibble > 15) return val;
         val <<= 4;
-        val |= pos;
+        val |= nibble;
         text.remove_prefix(1);
     }
     return val;
@@ -119,51 +194,114 @@ inline auto text(std::string_view& text, bool quoted = false) -> std::string {
 
 inline auto value(std::string_view& text, uint64_t max = 2147483647) -> uint64_t {
     uint64_t value = 0;
-    while (!text.empty() && isdigit(text.front())) {
-        value *= 10;
-        value += uint64_t(text.front() - '0');
-        if (value > max) {
-            value /= 10;
-            break;
-        }
+    uint64_t eight{0};
+    uint64_t next{0};
+    while (text.size() >= 8 && detail::swar_digits(text.data(), eight)) {
+        if (__builtin_mul_overflow(value, 100000000ULL, &next) || __builtin_add_overflow(next, eight, &next) || next > max) break;
+        value = next;
+        text.remove_prefix(8);
+    }
+    while (!text.empty() && detail::is_digit(text.front())) {
+        if (__builtin_mul_overflow(value, 10ULL, &next) || __builtin_add_overflow(next, uint64_t(text.front() - '0'), &next) || next > max) break;
+        value = next;
         text.remove_prefix(1);
     }
     return value;
 }
 
-inline auto decimal(std::string_view& text, uint64_t max = 2147483647) -> double {
-    auto integer = value(text, max);
-    double fraction = 0.0;
-    double divisor = 1.0;
-
-    if (!text.empty() && text.front() == '.') {
-        text.remove_prefix(1);
-        while (!text.empty() && isdigit(text.front())) {
-            divisor /= 10;
-            fraction += (text.front() - '0') * divisor;
-            text.remove_prefix(1);
+namespace detail {
+// Appends a run of digits to the mantissa, eight at a time while they
+// fit, and only counts those past the 19 that a uint64_t always holds.
+inline auto digits(const char *text, const char *end, decimal_t& num) noexcept -> const char * {
+    uint64_t eight{0};
+    while (num.digits <= 11 && end - text >= 8 && swar_digits(text, eight)) {
+        num.mantissa = num.mantissa * 100000000 + eight;
+        num.digits += 8;
+        text += 8;
+    }
+    while (num.digits < 19 && text < end && is_digit(*text)) {
+        num.mantissa = num.mantissa * 10 + uint64_t(*text - '0');
+        ++num.digits;
+        ++text;
+    }
+    while (text < end && is_digit(*text)) {
+        ++num.digits;
+        ++text;
+    }
+    return text;
+}
+
+// Scans a decimal number once, without converting it. A max of UINT64_MAX
+// leaves the integer part unbounded.
+inline auto scan_decimal(std::string_view& text, uint64_t max) noexcept -> decimal_t {
+    decimal_t num;
+    auto pos = text.data();
+    const auto end = pos + text.size();
+    while (pos < end && *pos == '0')
+        ++pos;
+    pos = digits(pos, end, num);
+    if (num.digits > 19) {
+        num.scale = num.digits - 19;
+        num.whole = false;
+    }
+    else
+        num.integer = num.mantissa;
+    if (num.integer > max || (num.digits > 19 && max != UINT64_MAX)) {
+        num = decimal_t{};
+        num.integer = value(text, max);
+        return num;
+    }
+    if (pos < end && *pos == '.') {
+        num.whole = false;
+        ++pos;
+        if (!num.digits) {
+            while (pos < end && *pos == '0') {
+                ++pos;
+                --num.scale;
+            }
         }
+        const auto kept = std::min(num.digits, 19);
+        pos = digits(pos, end, num);
+        num.scale -= std::min(num.digits, 19) - kept;
     }
-    return double(integer) + fraction;
+    text.remove_prefix(std::size_t(pos - text.data()));
+    return num;
+}
+} // namespace detail
+
+inline auto decimal(std::string_view& text, uint64_t max = 2147483647) -> double {
+    auto from = text.data();
+    const auto num = detail::scan_decimal(text, max);
+    if (num.whole) return double(num.integer);
+    return detail::to_double(from, text.data(), num, double(num.integer));
 }
 
 inline auto real(std::string_view& text, uint64_t max = 2147483647) -> double {
-    double number = decimal(text, max);
+    auto from = text.data();
+    auto num = detail::scan_decimal(text, max);
+    auto mantissa = text.data();
     if (!text.empty() && (text.front() == 'e' || text.front() == 'E')) {
-        text.remove_prefix(1);
-        bool negative = false;
-        if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
-            negative = (text.front() == '-');
-            text.remove_prefix(1);
+        auto exponent = text;
+        exponent.remove_prefix(1);
+        const auto neg = !exponent.empty() && exponent.front() == '-';
+        if (!exponent.empty() && (exponent.front() == '+' || exponent.front() == '-'))
+            exponent.remove_prefix(1);
+        auto digits = exponent.data();
+        auto exp = int(value(exponent, 99999));
+        if (exponent.data() != digits) {
+            // past any finite double, left for from_chars to round
+            while (!exponent.empty() && detail::is_digit(exponent.front())) {
+                exp = 100000;
+                exponent.remove_prefix(1);
+            }
+            text = exponent;
+            num.scale += neg ? -exp : exp;
+            return detail::to_double(from, text.data(), num, double(num.integer));
         }
-
-        auto exponent = int(value(text));
-        if (negative)
-            number *= std::pow(10, -exponent);
-        else
-            number *= std::pow(10, exponent);
+        text.remove_prefix(std::size_t(digits - text.data()));
     }
-    return number;
+    if (num.whole) return double(num.integer);
+    return detail::to_double(from, mantissa, num, double(num.integer));
 }
 
 inline auto match(std::string_view& text, const std::string_view& find, bool insensitive = false) {
@@ -244,7 +382,7 @@ inline auto get_decimal(std::string_view text) {
         text.remove_prefix(1);
     }
 
-    auto value = scan::decimal(text);
+    auto value = scan::decimal(text, UINT64_MAX);
     if (!text.empty()) throw std::invalid_argument("Value invalid");
     if (neg) return -value;
     return value;
@@ -265,7 +403,7 @@ inline auto get_real(std::string_view text) {
         text.remove_prefix(1);
     }
 
-    auto value = scan::real(text);
+    auto value = scan::real(text, UINT64_MAX);
     if (!text.empty()) throw std::invalid_argument("Value invalid");
     if (neg) return -value;
     return value;
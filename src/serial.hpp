@@ -15,6 +15,17 @@
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#if __has_include(<sys/epoll.h>)
+#include <sys/epoll.h>
+#define TYCHO_SERIAL_EPOLL
+#endif
 #else
 #if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__) || defined(WIN32)
 #if _WIN32_WINNT < 0x0600 && !defined(_MSC_VER)
@@ -29,11 +40,21 @@
 #endif
 
 #include <system_error>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <cstring>
 #include <cstdint>
 #include <cerrno>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 
 namespace tycho {
 using crc16_t = uint16_t;
@@ -130,7 +151,8 @@ public:
             char buf{0};
             err_ = 0;
             auto result = ::read(device_, &buf, 1);
-            if (result < 0) throw std::system_error(err_ = int(-result), std::generic_category(), "Serial i/o error");
+            if (result < 0 && is_again()) return EOF;
+            if (result < 0) throw std::system_error(err_ = errno, std::generic_category(), "Serial i/o error");
             if (result < 1) return EOF;
             if (echo && echo_code != EOF && (eol == EOF || buf != eol))
                 put(echo_code);
@@ -145,7 +167,8 @@ public:
         if (!data || !size) return std::size_t(0U);
         err_ = 0;
         auto count = ::read(device_, data, size);
-        if (count < 0) throw std::system_error(err_ = int(-count), std::generic_category(), "Serial i/o error");
+        if (count < 0 && is_again()) return std::size_t(0U);
+        if (count < 0) throw std::system_error(err_ = errno, std::generic_category(), "Serial i/o error");
         if (count > 0 && echo)
             put(data, count);
         if (count > 0) return std::size_t(count);
@@ -159,7 +182,8 @@ public:
         char buf = static_cast<char>(code);
         err_ = 0;
         auto result = ::write(device_, &buf, 1);
-        if (result < 0) throw std::system_error(err_ = int(-result), std::generic_category(), "Serial i/o error");
+        if (result < 0 && is_again()) return false;
+        if (result < 0) throw std::system_error(err_ = errno, std::generic_category(), "Serial i/o error");
         if (result < 1) return false;
         return true;
     }
@@ -169,7 +193,8 @@ public:
         err_ = 0;
         auto count = ::write(device_, data, size);
         if (count > 0) return std::size_t(count);
-        if (count < 0) throw std::system_error(err_ = int(-count), std::generic_category(), "Serial i/o error");
+        if (count < 0 && is_again()) return std::size_t(0U);
+        if (count < 0) throw std::system_error(err_ = errno, std::generic_category(), "Serial i/o error");
         return std::size_t(0U);
     }
 
@@ -177,6 +202,33 @@ public:
         return put(msg.data(), msg.size());
     }
 
+    auto handle() const noexcept {
+        return device_;
+    }
+
+    // non-blocking reads and writes return nothing rather than wait
+    auto set_blocking(bool enable) noexcept {
+        if (device_ < 0) return false;
+        auto io_flags = fcntl(device_, F_GETFL);
+        if (io_flags < 0) return false;
+        io_flags = enable ? (io_flags & ~O_NONBLOCK) : (io_flags | O_NONBLOCK);
+        return fcntl(device_, F_SETFL, io_flags) == 0;
+    }
+
+    auto is_blocking() const noexcept {
+        if (device_ < 0) return false;
+        return (fcntl(device_, F_GETFL) & O_NONBLOCK) == 0;
+    }
+
+    auto wait(short events, int timeout = -1) const noexcept -> int {
+        if (device_ < 0) return 0;
+        struct pollfd pfd{};
+        pfd.fd = device_;
+        pfd.events = events;
+        if (::poll(&pfd, 1, timeout) < 0) err_ = errno;
+        return pfd.revents;
+    }
+
     auto is_packet() const noexcept {
         if (device_ < 0) return false;
         return 0 == (current_.c_lflag & ICANON);
@@ -429,6 +481,10 @@ private:
     struct termios original_{}, current_{};
     mutable int err_{0};
 
+    static auto is_again() noexcept -> bool {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
     void reset() {
         if (device_ < 0) return;
         current_.c_oflag = current_.c_lflag = 0;
@@ -741,6 +797,368 @@ private:
 };
 #endif
 
+#if __has_include(<termios.h>)
+// Byte ring that input is read into in batches, directly from a device.
+class serial_ring final {
+public:
+    explicit serial_ring(std::size_t size = 4096) : data_(size ? size : 1) {}
+
+    auto size() const noexcept {
+        return count_;
+    }
+
+    auto capacity() const noexcept {
+        return data_.size();
+    }
+
+    auto space() const noexcept {
+        return data_.size() - count_;
+    }
+
+    auto empty() const noexcept {
+        return count_ == 0;
+    }
+
+    auto full() const noexcept {
+        return count_ == data_.size();
+    }
+
+    // contiguous run of buffered input, which may be less than size()
+    auto front() const noexcept -> std::pair<const uint8_t *, std::size_t> {
+        return {data_.data() + head_, std::min(count_, data_.size() - head_)};
+    }
+
+    auto peek(uint8_t *out, std::size_t size) const noexcept {
+        size = std::min(size, count_);
+        const auto first = std::min(size, data_.size() - head_);
+        memcpy(out, data_.data() + head_, first);
+        memcpy(out + first, data_.data(), size - first);
+        return size;
+    }
+
+    auto read(uint8_t *out, std::size_t size) noexcept {
+        size = peek(out, size);
+        consume(size);
+        return size;
+    }
+
+    void consume(std::size_t size) noexcept {
+        size = std::min(size, count_);
+        head_ = (head_ + size) % data_.size();
+        count_ -= size;
+        if (!count_)
+            head_ = 0;
+    }
+
+    auto write(const uint8_t *in, std::size_t size) noexcept {
+        size = std::min(size, space());
+        const auto tail = (head_ + count_) % data_.size();
+        const auto first = std::min(size, data_.size() - tail);
+        memcpy(data_.data() + tail, in, first);
+        memcpy(data_.data(), in + first, size - first);
+        count_ += size;
+        return size;
+    }
+
+    // one readv into the free space; -1 with errno on error
+    auto fill(int fd) noexcept -> ssize_t {
+        if (full()) return 0;
+        const auto tail = (head_ + count_) % data_.size();
+        struct iovec vec[2]{};
+        vec[0].iov_base = data_.data() + tail;
+        vec[0].iov_len = std::min(space(), data_.size() - tail);
+        vec[1].iov_base = data_.data();
+        vec[1].iov_len = space() - vec[0].iov_len;
+        auto count = ::readv(fd, vec, vec[1].iov_len ? 2 : 1);
+        if (count > 0)
+            count_ += std::size_t(count);
+        return count;
+    }
+
+    void clear() noexcept {
+        head_ = count_ = 0;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+    std::size_t head_{0}, count_{0};
+};
+
+// Drives many non-blocking serial ports from one thread. Input is batched
+// into a ring per port and handed to its receiver; writes are queued and
+// completed with a callback once fully written. Not thread safe: attach,
+// write, and poll belong to the thread running the reactor.
+class serial_reactor final {
+public:
+    using receiver_t = std::function<void(serial_t&, serial_ring&)>;
+    using complete_t = std::function<void(std::size_t, int)>;
+
+    explicit serial_reactor(std::size_t ring = 4096) : ring_(ring) {
+#ifdef TYCHO_SERIAL_EPOLL
+        poller_ = epoll_create1(EPOLL_CLOEXEC);
+        if (poller_ < 0) throw std::system_error(errno, std::generic_category(), "Serial reactor failed");
+#endif
+    }
+
+    serial_reactor(const serial_reactor&) = delete;
+    auto operator=(const serial_reactor&) -> serial_reactor& = delete;
+
+    ~serial_reactor() {
+        for (auto& [fd, port] : ports_) {
+            cancel(*port, ECANCELED);
+            if (port->blocking)
+                port->port.set_blocking(true);
+        }
+#ifdef TYCHO_SERIAL_EPOLL
+        if (poller_ > -1)
+            ::close(poller_);
+#endif
+    }
+
+    auto size() const noexcept {
+        return ports_.size();
+    }
+
+    // The port is made non-blocking while attached and restored on removal.
+    // A receiver that leaves the ring full pauses input until the ring is
+    // drained, which can also be done later through the ring it was given.
+    auto attach(serial_t& port, receiver_t receiver) -> bool {
+        const auto fd = port.handle();
+        if (fd < 0 || !receiver || ports_.count(fd)) return false;
+        const auto blocking = port.is_blocking();
+        if (!port.set_blocking(false)) return false;
+        auto entry = std::make_unique<port_t>(port, std::move(receiver), ring_);
+        entry->blocking = blocking;
+#ifdef TYCHO_SERIAL_EPOLL
+        struct epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(poller_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            port.set_blocking(blocking);
+            return false;
+        }
+#endif
+        ports_.emplace(fd, std::move(entry));
+        return true;
+    }
+
+    // pending writes are completed with ECANCELED
+    auto detach(serial_t& port) -> bool {
+        auto it = ports_.find(port.handle());
+        if (it == ports_.end()) return false;
+        remove(*it->second);
+        return true;
+    }
+
+    // Queues a copy of the data; the completion may run before this returns
+    // if the device accepts it all at once.
+    auto write(serial_t& port, const void *data, std::size_t size, complete_t done = nullptr) -> bool {
+        auto it = ports_.find(port.handle());
+        if (it == ports_.end() || it->second->removed || !size) return false;
+        auto& entry = *it->second;
+        auto ptr = static_cast<const uint8_t *>(data);
+        entry.writes.push_back({std::vector<uint8_t>(ptr, ptr + size), 0, std::move(done)});
+        if (entry.writes.size() == 1) {
+            const auto prior = dispatching_;
+            dispatching_ = true;
+            flush(entry);
+            dispatching_ = prior;
+            if (!prior)
+                cleanup();
+        }
+        return true;
+    }
+
+    auto write(serial_t& port, std::string_view msg, complete_t done = nullptr) -> bool {
+        return write(port, msg.data(), msg.size(), std::move(done));
+    }
+
+    auto pending(const serial_t& port) const noexcept {
+        auto it = ports_.find(port.handle());
+        std::size_t total = 0;
+        if (it == ports_.end()) return total;
+        for (const auto& item : it->second->writes)
+            total += item.data.size() - item.offset;
+        return total;
+    }
+
+    // Waits up to timeout ms and services ready ports; returns how many.
+    auto poll(int timeout = -1) -> std::size_t {
+        std::size_t count = 0;
+        if (paused_)
+            resume();
+        dispatching_ = true;
+#ifdef TYCHO_SERIAL_EPOLL
+        struct epoll_event events[64];
+        auto ready = epoll_wait(poller_, events, 64, timeout);
+        for (auto pos = 0; pos < ready; ++pos) {
+            auto it = ports_.find(events[pos].data.fd);
+            if (it == ports_.end() || it->second->removed) continue;
+            const auto ev = events[pos].events;
+            service(*it->second, (ev & EPOLLIN) != 0, (ev & EPOLLOUT) != 0, (ev & (EPOLLHUP | EPOLLERR)) != 0);
+            ++count;
+        }
+#else
+        std::vector<struct pollfd> fds;
+        fds.reserve(ports_.size());
+        for (const auto& [fd, port] : ports_) {
+            struct pollfd pfd{};
+            pfd.fd = fd;
+            pfd.events = short((port->paused ? 0 : POLLIN) | (port->writes.empty() ? 0 : POLLOUT));
+            fds.push_back(pfd);
+        }
+        auto ready = ::poll(fds.data(), fds.size(), timeout);
+        for (std::size_t pos = 0; ready > 0 && pos < fds.size(); ++pos) {
+            const auto ev = fds[pos].revents;
+            if (!ev) continue;
+            --ready;
+            auto it = ports_.find(fds[pos].fd);
+            if (it == ports_.end() || it->second->removed) continue;
+            service(*it->second, (ev & POLLIN) != 0, (ev & POLLOUT) != 0, (ev & (POLLHUP | POLLERR | POLLNVAL)) != 0);
+            ++count;
+        }
+#endif
+        dispatching_ = false;
+        cleanup();
+        return count;
+    }
+
+private:
+    struct pending_t {
+        std::vector<uint8_t> data;
+        std::size_t offset{0};
+        complete_t done;
+    };
+
+    struct port_t {
+        port_t(serial_t& from, receiver_t&& recv, std::size_t ring) : port(from), receiver(std::move(recv)), input(ring) {}
+
+        serial_t& port;
+        receiver_t receiver;
+        serial_ring input;
+        std::deque<pending_t> writes;
+        bool output{false}, paused{false}, removed{false}, blocking{true};
+    };
+
+    std::unordered_map<int, std::unique_ptr<port_t>> ports_;
+    std::vector<int> removed_;
+    std::size_t ring_{4096};
+    std::size_t paused_{0};
+    bool dispatching_{false};
+#ifdef TYCHO_SERIAL_EPOLL
+    int poller_{-1};
+#endif
+
+    void service(port_t& entry, bool input, bool output, bool hangup) {
+        if (input || hangup)
+            receive(entry);
+        if (!entry.removed && output)
+            flush(entry);
+        if (!entry.removed && hangup)
+            remove(entry, EPIPE);
+    }
+
+    void receive(port_t& entry) {
+        const auto fd = entry.port.handle();
+        auto failed = 0;
+        for (;;) {
+            auto count = entry.input.fill(fd);
+            if (count > 0) continue;
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+                failed = errno;
+            break;
+        }
+        if (!entry.input.empty())
+            entry.receiver(entry.port, entry.input);
+        if (failed && !entry.removed)
+            remove(entry, failed);
+        else if (!entry.removed)
+            interest(entry, entry.output, entry.input.full());
+    }
+
+    void flush(port_t& entry) {
+        const auto fd = entry.port.handle();
+        while (!entry.writes.empty()) {
+            auto& item = entry.writes.front();
+            auto count = ::write(fd, item.data.data() + item.offset, item.data.size() - item.offset);
+            if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (count < 0) {
+                const auto err = errno;
+                auto done = std::move(item.done);
+                auto offset = item.offset;
+                entry.writes.pop_front();
+                if (done) done(offset, err);
+                if (entry.removed) return;
+                continue;
+            }
+            item.offset += std::size_t(count);
+            if (item.offset < item.data.size()) continue;
+            auto done = std::move(item.done);
+            auto size = item.data.size();
+            entry.writes.pop_front();
+            if (done) done(size, 0);
+            if (entry.removed) return;
+        }
+        interest(entry, !entry.writes.empty(), entry.paused);
+    }
+
+    // level triggered input is dropped while the ring is full so a receiver
+    // that holds data back does not spin poll
+    void interest(port_t& entry, bool output, bool paused) {
+        if (entry.output == output && entry.paused == paused) return;
+        if (entry.paused != paused)
+            paused_ = paused ? paused_ + 1 : paused_ - 1;
+        entry.output = output;
+        entry.paused = paused;
+#ifdef TYCHO_SERIAL_EPOLL
+        struct epoll_event ev{};
+        ev.events = (paused ? 0U : uint32_t(EPOLLIN)) | (output ? uint32_t(EPOLLOUT) : 0U);
+        ev.data.fd = entry.port.handle();
+        epoll_ctl(poller_, EPOLL_CTL_MOD, ev.data.fd, &ev);
+#endif
+    }
+
+    void resume() {
+        for (auto& [fd, port] : ports_) {
+            if (port->paused && !port->removed && !port->input.full())
+                interest(*port, port->output, false);
+        }
+    }
+
+    void cleanup() {
+        for (auto fd : removed_)
+            ports_.erase(fd);
+        removed_.clear();
+    }
+
+    static void cancel(port_t& entry, int err) {
+        while (!entry.writes.empty()) {
+            auto item = std::move(entry.writes.front());
+            entry.writes.pop_front();
+            if (item.done) item.done(item.offset, err);
+        }
+    }
+
+    void remove(port_t& entry, int err = ECANCELED) {
+        const auto fd = entry.port.handle();
+        if (entry.paused)
+            --paused_;
+        entry.paused = false;
+        entry.removed = true;
+#ifdef TYCHO_SERIAL_EPOLL
+        epoll_ctl(poller_, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+        if (entry.blocking)
+            entry.port.set_blocking(true);
+        cancel(entry, err);
+        if (dispatching_)
+            removed_.push_back(fd);
+        else
+            ports_.erase(fd);
+    }
+};
+#endif
+
 template <typename T>
 inline auto send(const serial_t& sio, const T& msg) {
     static_assert(std::is_trivial_v<T>, "T must be Trivial type");
@@ -808,35 +1226,721 @@ inline auto csum8(const uint8_t *data, std::size_t size) {
     return sum;
 }
 
-inline auto crc16(const uint8_t *data, std::size_t size) {
-    crc16_t crc = 0x0000;
-    while (size--) {
-        crc ^= *data++ << 8;
-        for (uint8_t i = 0; i < 8; i++) {
-            if (crc & 0x8000)
-                crc = (crc << 1) ^ 0x8005;
-            else
-                crc <<= 1;
+namespace detail {
+// Slicing-by-8 tables for a reflected 32 bit polynomial, built at compile time.
+constexpr auto make_crc32_tables(crc32_t poly) {
+    std::array<std::array<crc32_t, 256>, 8> tables{};
+    for (crc32_t pos = 0; pos < 256; ++pos) {
+        auto crc = pos;
+        for (auto bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? poly ^ (crc >> 1) : crc >> 1;
+        tables[0][pos] = crc;
+    }
+    for (std::size_t slice = 1; slice < 8; ++slice) {
+        for (std::size_t pos = 0; pos < 256; ++pos) {
+            auto prior = tables[slice - 1][pos];
+            tables[slice][pos] = (prior >> 8) ^ tables[0][prior & 0xff];
         }
     }
+    return tables;
+}
+
+constexpr auto make_crc16_table(crc16_t poly) {
+    std::array<crc16_t, 256> table{};
+    for (unsigned pos = 0; pos < 256; ++pos) {
+        auto crc = crc16_t(pos << 8);
+        for (auto bit = 0; bit < 8; ++bit)
+            crc = (crc & 0x8000) ? crc16_t((crc << 1) ^ poly) : crc16_t(crc << 1);
+        table[pos] = crc;
+    }
+    return table;
+}
+
+inline constexpr auto crc32_tables = make_crc32_tables(0xedb88320);
+inline constexpr auto crc32c_tables = make_crc32_tables(0x82f63b78);
+inline constexpr auto crc16_table = make_crc16_table(0x8005);
+
+inline auto crc32_slice8(const std::array<std::array<crc32_t, 256>, 8>& t, crc32_t crc, const uint8_t *data, std::size_t size) noexcept {
+    while (size >= 8) {
+        const auto one = crc ^ (crc32_t(data[0]) | (crc32_t(data[1]) << 8) | (crc32_t(data[2]) << 16) | (crc32_t(data[3]) << 24));
+        const auto two = crc32_t(data[4]) | (crc32_t(data[5]) << 8) | (crc32_t(data[6]) << 16) | (crc32_t(data[7]) << 24);
+        crc = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^ t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+              t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^ t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size--)
+        crc = t[0][(crc ^ *(data++)) & 0xff] ^ (crc >> 8);
     return crc;
 }
 
-inline auto crc32(const uint8_t *data, std::size_t size) {
-    crc32_t table[256]{0};
-    crc32_t crc = 0xffffffff;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TYCHO_SERIAL_X86
+
+inline auto cpu_sse42() noexcept {
+    static const bool sse42 = __builtin_cpu_supports("sse4.2");
+    return sse42;
+}
+
+inline auto cpu_pclmul() noexcept {
+    static const bool pclmul = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    return pclmul;
+}
+
+__attribute__((target("sse4.2"))) inline auto crc32c_sse42(crc32_t crc, const uint8_t *data, std::size_t size) noexcept {
+    uint64_t wide = crc;
+    while (size >= 8) {
+        uint64_t word{0};
+        memcpy(&word, data, sizeof(word));
+        wide = _mm_crc32_u64(wide, word);
+        data += 8;
+        size -= 8;
+    }
+    crc = crc32_t(wide);
+    while (size--)
+        crc = _mm_crc32_u8(crc, *(data++));
+    return crc;
+}
 
-    for (std::size_t i = 0; i < 256; i++) {
-        crc32_t c = i;
-        for (std::size_t j = 0; j < 8; j++)
-            c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
-        table[i] = c;
+__attribute__((target("pclmul,sse4.1"))) inline auto crc32_load(const uint8_t *data) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+}
+
+__attribute__((target("pclmul,sse4.1"))) inline auto crc32_fold(__m128i x, __m128i k, __m128i next) noexcept {
+    auto low = _mm_clmulepi64_si128(x, k, 0x00);
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), next), low);
+}
+
+// Carry-less multiply folding for the ieee polynomial. Needs size >= 64
+// and a multiple of 16; returns the updated crc register.
+__attribute__((target("pclmul,sse4.1"))) inline auto crc32_pclmul(crc32_t crc, const uint8_t *data, std::size_t size) noexcept {
+    const auto k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const auto k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const auto k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const auto poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    auto x1 = _mm_xor_si128(crc32_load(data), _mm_cvtsi32_si128(int(crc)));
+    auto x2 = crc32_load(data + 0x10);
+    auto x3 = crc32_load(data + 0x20);
+    auto x4 = crc32_load(data + 0x30);
+    std::size_t pos = 64;
+    for (; pos + 64 <= size; pos += 64) {
+        auto x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        auto x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        auto x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        auto x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k1k2, 0x11), x5), crc32_load(data + pos));
+        x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, k1k2, 0x11), x6), crc32_load(data + pos + 0x10));
+        x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, k1k2, 0x11), x7), crc32_load(data + pos + 0x20));
+        x4 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x4, k1k2, 0x11), x8), crc32_load(data + pos + 0x30));
     }
 
-    for (std::size_t i = 0; i < size; i++)
-        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    x1 = crc32_fold(x1, k3k4, x2);
+    x1 = crc32_fold(x1, k3k4, x3);
+    x1 = crc32_fold(x1, k3k4, x4);
+    for (; pos + 16 <= size; pos += 16)
+        x1 = crc32_fold(x1, k3k4, crc32_load(data + pos));
+
+    // 128 to 64 bits, then barrett reduce to 32
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), k5k0, 0x00), x2);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), poly, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), poly, 0x00);
+    return crc32_t(_mm_extract_epi32(_mm_xor_si128(x1, x2), 1));
+}
+#endif
+} // namespace detail
+
+// Incremental forms work on the crc register: start from the init value,
+// update any number of times, then final to get the checksum.
+inline constexpr auto crc16_init() noexcept {
+    return crc16_t(0x0000);
+}
+
+inline auto crc16_update(crc16_t crc, const uint8_t *data, std::size_t size) noexcept {
+    while (size--)
+        crc = crc16_t((crc << 8) ^ detail::crc16_table[((crc >> 8) ^ *(data++)) & 0xff]);
+    return crc;
+}
+
+inline constexpr auto crc16_final(crc16_t crc) noexcept {
+    return crc;
+}
+
+inline constexpr auto crc32_init() noexcept {
+    return crc32_t(0xffffffff);
+}
+
+inline auto crc32_update(crc32_t crc, const uint8_t *data, std::size_t size) noexcept {
+#if defined(TYCHO_SERIAL_X86)
+    if (size >= 64 && detail::cpu_pclmul()) {
+        const auto bulk = size & ~std::size_t(15);
+        crc = detail::crc32_pclmul(crc, data, bulk);
+        data += bulk;
+        size -= bulk;
+    }
+#elif defined(__ARM_FEATURE_CRC32)
+    while (size >= 8) {
+        uint64_t word{0};
+        memcpy(&word, data, sizeof(word));
+        crc = __crc32d(crc, word);
+        data += 8;
+        size -= 8;
+    }
+#endif
+    return detail::crc32_slice8(detail::crc32_tables, crc, data, size);
+}
 
+inline constexpr auto crc32_final(crc32_t crc) noexcept {
     return crc ^ 0xffffffff;
 }
+
+inline auto crc32c_update(crc32_t crc, const uint8_t *data, std::size_t size) noexcept {
+#if defined(TYCHO_SERIAL_X86)
+    if (detail::cpu_sse42()) return detail::crc32c_sse42(crc, data, size);
+#elif defined(__ARM_FEATURE_CRC32)
+    while (size >= 8) {
+        uint64_t word{0};
+        memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += 8;
+        size -= 8;
+    }
+#endif
+    return detail::crc32_slice8(detail::crc32c_tables, crc, data, size);
+}
+
+template <typename T, T (*Update)(T, const uint8_t *, std::size_t), T Init, T Xor>
+class crc_engine final {
+public:
+    using value_type = T;
+
+    constexpr crc_engine() noexcept = default;
+
+    void init() noexcept {
+        crc_ = Init;
+    }
+
+    auto update(const uint8_t *data, std::size_t size) noexcept -> auto& {
+        crc_ = Update(crc_, data, size);
+        return *this;
+    }
+
+    auto update(std::string_view text) noexcept -> auto& {
+        return update(reinterpret_cast<const uint8_t *>(text.data()), text.size());
+    }
+
+    auto final() const noexcept -> T {
+        return crc_ ^ Xor;
+    }
+
+private:
+    T crc_{Init};
+};
+
+using crc16_engine = crc_engine<crc16_t, crc16_update, 0x0000, 0x0000>;
+using crc32_engine = crc_engine<crc32_t, crc32_update, 0xffffffff, 0xffffffff>;
+using crc32c_engine = crc_engine<crc32_t, crc32c_update, 0xffffffff, 0xffffffff>;
+
+inline auto crc16(const uint8_t *data, std::size_t size) {
+    return crc16_final(crc16_update(crc16_init(), data, size));
+}
+
+inline auto crc32(const uint8_t *data, std::size_t size) {
+    return crc32_final(crc32_update(crc32_init(), data, size));
+}
+
+inline auto crc32c(const uint8_t *data, std::size_t size) {
+    return crc32_final(crc32c_update(crc32_init(), data, size));
+}
+enum class frame_crc : uint8_t { none, crc16, crc32, crc32c };
+
+constexpr auto crc_size(frame_crc crc) noexcept -> std::size_t {
+    switch (crc) {
+    case frame_crc::crc16:
+        return 2;
+    case frame_crc::crc32:
+    case frame_crc::crc32c:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+namespace detail {
+inline auto frame_checksum(frame_crc crc, const uint8_t *data, std::size_t size) noexcept -> uint32_t {
+    switch (crc) {
+    case frame_crc::crc16:
+        return crc16(data, size);
+    case frame_crc::crc32:
+        return crc32(data, size);
+    case frame_crc::crc32c:
+        return crc32c(data, size);
+    default:
+        return 0;
+    }
+}
+
+// appends the checksum big endian
+inline void frame_append(frame_crc crc, const uint8_t *data, std::size_t size, uint8_t *out) noexcept {
+    const auto sum = frame_checksum(crc, data, size);
+    const auto bytes = crc_size(crc);
+    for (std::size_t pos = 0; pos < bytes; ++pos)
+        out[pos] = uint8_t(sum >> ((bytes - pos - 1) * 8));
+}
+
+inline auto frame_verify(frame_crc crc, const uint8_t *data, std::size_t size) noexcept {
+    const auto bytes = crc_size(crc);
+    if (size < bytes) return false;
+    if (!bytes) return true;
+    uint8_t sum[4];
+    frame_append(crc, data, size - bytes, sum);
+    return memcmp(sum, data + size - bytes, bytes) == 0;
+}
+
+// text framing carries the checksum as upper case hex
+inline void frame_append_hex(frame_crc crc, const uint8_t *data, std::size_t size, uint8_t *out) noexcept {
+    constexpr char digits[] = "0123456789ABCDEF";
+    uint8_t sum[4];
+    frame_append(crc, data, size, sum);
+    for (std::size_t pos = 0; pos < crc_size(crc); ++pos) {
+        out[pos * 2] = uint8_t(digits[sum[pos] >> 4]);
+        out[(pos * 2) + 1] = uint8_t(digits[sum[pos] & 0x0f]);
+    }
+}
+
+inline auto frame_verify_hex(frame_crc crc, const uint8_t *data, std::size_t size) noexcept {
+    const auto bytes = crc_size(crc) * 2;
+    if (size < bytes) return false;
+    if (!bytes) return true;
+    uint8_t sum[8];
+    frame_append_hex(crc, data, size - bytes, sum);
+    return memcmp(sum, data + size - bytes, bytes) == 0;
+}
+
+inline constexpr auto cobs_error = std::size_t(-1);
+
+// Decodes in place safely, since output never passes input.
+inline auto cobs_decode(const uint8_t *in, std::size_t size, uint8_t *out) noexcept {
+    std::size_t from = 0, to = 0;
+    while (from < size) {
+        const auto code = in[from++];
+        if (!code || from + code - 1 > size) return cobs_error;
+        for (auto pos = 1; pos < code; ++pos)
+            out[to++] = in[from++];
+        if (code < 0xff && from < size)
+            out[to++] = 0;
+    }
+    return to;
+}
+} // namespace detail
+
+// Incremental decoders take chunks as they are read and call a function
+// with each complete frame (data, size), less any checksum. The frame is a
+// view into the input chunk or the decoder buffer, valid only for the call.
+// Oversized, malformed, or failed checksum frames are dropped and counted.
+class frame_decoder {
+public:
+    auto errors() const noexcept {
+        return errors_;
+    }
+
+    auto max_size() const noexcept {
+        return max_;
+    }
+
+    auto crc() const noexcept {
+        return crc_;
+    }
+
+protected:
+    std::vector<uint8_t> buffer_;
+    std::size_t max_, errors_{0};
+    frame_crc crc_;
+    bool hex_{false};
+    bool bad_{false};
+
+    frame_decoder(std::size_t max, frame_crc crc, bool hex = false) : max_(max), crc_(crc), hex_(hex) {
+        buffer_.reserve(limit());
+    }
+
+    auto trailer() const noexcept -> std::size_t {
+        return crc_size(crc_) * (hex_ ? 2 : 1);
+    }
+
+    auto limit() const noexcept -> std::size_t {
+        return max_ + trailer();
+    }
+
+    template <typename Func>
+    auto emit(const uint8_t *data, std::size_t size, Func& func) -> bool {
+        const auto valid = hex_ ? detail::frame_verify_hex(crc_, data, size) : detail::frame_verify(crc_, data, size);
+        if (size > limit() || !valid) {
+            ++errors_;
+            return false;
+        }
+        func(data, size - trailer());
+        return true;
+    }
+
+    void append(const uint8_t *data, std::size_t size) {
+        if (bad_) return;
+        if (buffer_.size() + size > limit()) {
+            bad_ = true;
+            return;
+        }
+        buffer_.insert(buffer_.end(), data, data + size);
+    }
+
+    void restart() noexcept {
+        buffer_.clear();
+        bad_ = false;
+    }
+};
+
+class slip_decoder final : public frame_decoder {
+public:
+    static constexpr uint8_t end = 0xc0, esc = 0xdb, esc_end = 0xdc, esc_esc = 0xdd;
+
+    explicit slip_decoder(std::size_t max = 1024, frame_crc crc = frame_crc::none) : frame_decoder(max, crc) {}
+
+    template <typename Func>
+    auto feed(const uint8_t *data, std::size_t size, Func func) -> std::size_t {
+        std::size_t frames = 0;
+        const auto last = data + size;
+        while (data < last) {
+            if (escaped_) {
+                escaped_ = false;
+                const auto code = *(data++);
+                if (code == esc_end || code == esc_esc) {
+                    const uint8_t value = (code == esc_end) ? end : esc;
+                    append(&value, 1);
+                } else
+                    bad_ = true;
+                continue;
+            }
+
+            auto stop = std::find_if(data, last, [](uint8_t code) { return code == end || code == esc; });
+            if (stop < last && *stop == end && buffer_.empty() && !bad_) {
+                // whole unescaped frame in this chunk, no copy
+                if (stop > data && emit(data, std::size_t(stop - data), func))
+                    ++frames;
+                data = stop + 1;
+                continue;
+            }
+
+            append(data, std::size_t(stop - data));
+            data = stop;
+            if (data == last) break;
+            if (*(data++) == esc) {
+                escaped_ = true;
+                continue;
+            }
+
+            if (bad_)
+                ++errors_;
+            else if (!buffer_.empty() && emit(buffer_.data(), buffer_.size(), func))
+                ++frames;
+            restart();
+        }
+        return frames;
+    }
+
+    void reset() noexcept {
+        restart();
+        escaped_ = false;
+    }
+
+private:
+    bool escaped_{false};
+};
+
+class cobs_decoder final : public frame_decoder {
+public:
+    explicit cobs_decoder(std::size_t max = 1024, frame_crc crc = frame_crc::none) : frame_decoder(max, crc) {
+        buffer_.reserve(limit() + limit() / 254 + 2);
+    }
+
+    template <typename Func>
+    auto feed(const uint8_t *data, std::size_t size, Func func) -> std::size_t {
+        std::size_t frames = 0;
+        const auto last = data + size;
+        while (data < last) {
+            auto stop = static_cast<const uint8_t *>(memchr(data, 0, std::size_t(last - data)));
+            if (!stop) {
+                collect(data, std::size_t(last - data));
+                break;
+            }
+
+            const auto count = std::size_t(stop - data);
+            if (buffer_.empty() && !bad_) {
+                // decode straight from the chunk into the frame buffer
+                if (count && count <= encoded_limit()) {
+                    buffer_.resize(count);
+                    if (decode(data, count, func))
+                        ++frames;
+                } else if (count)
+                    ++errors_;
+            } else {
+                collect(data, count);
+                if (bad_)
+                    ++errors_;
+                else if (decode(buffer_.data(), buffer_.size(), func))
+                    ++frames;
+            }
+            restart();
+            data = stop + 1;
+        }
+        return frames;
+    }
+
+    void reset() noexcept {
+        restart();
+    }
+
+private:
+    auto encoded_limit() const noexcept {
+        return limit() + limit() / 254 + 1;
+    }
+
+    void collect(const uint8_t *data, std::size_t size) {
+        if (bad_) return;
+        if (buffer_.size() + size > encoded_limit()) {
+            bad_ = true;
+            return;
+        }
+        buffer_.insert(buffer_.end(), data, data + size);
+    }
+
+    template <typename Func>
+    auto decode(const uint8_t *in, std::size_t size, Func& func) -> bool {
+        const auto used = detail::cobs_decode(in, size, buffer_.data());
+        if (used == detail::cobs_error) {
+            ++errors_;
+            return false;
+        }
+        return emit(buffer_.data(), used, func);
+    }
+};
+
+// Frames carry a big endian length of 1, 2, or 4 bytes that counts the
+// payload and checksum.
+class length_decoder final : public frame_decoder {
+public:
+    explicit length_decoder(std::size_t max = 1024, std::size_t header = 2, frame_crc crc = frame_crc::none) : frame_decoder(max, crc), header_(header) {
+        if (header != 1 && header != 2 && header != 4) throw std::invalid_argument("Invalid frame header size");
+    }
+
+    template <typename Func>
+    auto feed(const uint8_t *data, std::size_t size, Func func) -> std::size_t {
+        std::size_t frames = 0;
+        const auto last = data + size;
+        while (data < last) {
+            if (skip_) {
+                const auto count = std::min(skip_, std::size_t(last - data));
+                data += count;
+                skip_ -= count;
+                continue;
+            }
+
+            if (!have_ && std::size_t(last - data) >= header_) {
+                const auto length = parse(data);
+                if (length <= limit() && std::size_t(last - data) - header_ >= length) {
+                    // whole frame in this chunk, no copy
+                    if (emit(data + header_, length, func))
+                        ++frames;
+                    data += header_ + length;
+                    continue;
+                }
+            }
+
+            if (have_ < header_) {
+                header_data_[have_++] = *(data++);
+                if (have_ < header_) continue;
+                need_ = parse(header_data_);
+                if (need_ > limit()) {
+                    ++errors_;
+                    skip_ = need_;
+                    have_ = 0;
+                    continue;
+                }
+            }
+
+            const auto count = std::min(need_ - buffer_.size(), std::size_t(last - data));
+            append(data, count);
+            data += count;
+            if (buffer_.size() < need_) continue;
+            if (emit(buffer_.data(), buffer_.size(), func))
+                ++frames;
+            restart();
+            have_ = 0;
+        }
+        return frames;
+    }
+
+    void reset() noexcept {
+        restart();
+        have_ = need_ = skip_ = 0;
+    }
+
+private:
+    std::size_t header_, have_{0}, need_{0}, skip_{0};
+    uint8_t header_data_[4]{0};
+
+    auto parse(const uint8_t *data) const noexcept {
+        std::size_t length = 0;
+        for (std::size_t pos = 0; pos < header_; ++pos)
+            length = (length << 8) | data[pos];
+        return length;
+    }
+};
+
+// The checksum is hex text here, so a binary trailer can never contain the
+// delimiter and split the frame.
+class delimiter_decoder final : public frame_decoder {
+public:
+    explicit delimiter_decoder(std::string_view delim = "\n", std::size_t max = 1024, frame_crc crc = frame_crc::none) : frame_decoder(max, crc, true), delim_(delim) {
+        if (delim_.empty()) throw std::invalid_argument("Empty frame delimiter");
+        buffer_.reserve(limit() + delim_.size());
+    }
+
+    template <typename Func>
+    auto feed(const uint8_t *data, std::size_t size, Func func) -> std::size_t {
+        std::size_t frames = 0;
+        const auto last = data + size;
+        while (data < last) {
+            const auto chunk = std::string_view(reinterpret_cast<const char *>(data), std::size_t(last - data));
+            if (buffer_.empty() && !bad_) {
+                const auto pos = chunk.find(delim_);
+                if (pos != std::string_view::npos) {
+                    // whole frame in this chunk, no copy
+                    if (emit(data, pos, func))
+                        ++frames;
+                    data += pos + delim_.size();
+                    continue;
+                }
+            }
+
+            // the delimiter may straddle the previous chunk
+            const auto prior = buffer_.size();
+            buffer_.insert(buffer_.end(), data, last);
+            const auto view = std::string_view(reinterpret_cast<const char *>(buffer_.data()), buffer_.size());
+            const auto pos = view.find(delim_, prior >= delim_.size() ? prior - delim_.size() + 1 : 0);
+            if (pos == std::string_view::npos) {
+                if (buffer_.size() > limit() + delim_.size()) {
+                    // keep only what could begin a delimiter
+                    bad_ = true;
+                    buffer_.erase(buffer_.begin(), buffer_.end() - std::ptrdiff_t(delim_.size() - 1));
+                }
+                break;
+            }
+
+            if (bad_)
+                ++errors_;
+            else if (emit(buffer_.data(), pos, func))
+                ++frames;
+            data += pos + delim_.size() - prior;
+            restart();
+        }
+        return frames;
+    }
+
+    void reset() noexcept {
+        restart();
+    }
+
+private:
+    std::string delim_;
+};
+
+// Encoders build one complete frame, with optional checksum, into a reusable
+// buffer so it can be sent with a single put.
+inline auto slip_encode(const uint8_t *data, std::size_t size, std::vector<uint8_t>& out, frame_crc crc = frame_crc::none) {
+    uint8_t sum[4];
+    detail::frame_append(crc, data, size, sum);
+    out.clear();
+    out.reserve((size + crc_size(crc)) * 2 + 2);
+    auto put = [&out](const uint8_t *from, std::size_t count) {
+        for (std::size_t pos = 0; pos < count; ++pos) {
+            switch (from[pos]) {
+            case slip_decoder::end:
+                out.push_back(slip_decoder::esc);
+                out.push_back(slip_decoder::esc_end);
+                break;
+            case slip_decoder::esc:
+                out.push_back(slip_decoder::esc);
+                out.push_back(slip_decoder::esc_esc);
+                break;
+            default:
+                out.push_back(from[pos]);
+            }
+        }
+    };
+    out.push_back(slip_decoder::end);
+    put(data, size);
+    put(sum, crc_size(crc));
+    out.push_back(slip_decoder::end);
+    return out.size();
+}
+
+inline auto cobs_encode(const uint8_t *data, std::size_t size, std::vector<uint8_t>& out, frame_crc crc = frame_crc::none) {
+    uint8_t sum[4];
+    detail::frame_append(crc, data, size, sum);
+    const auto total = size + crc_size(crc);
+    out.clear();
+    out.reserve(total + total / 254 + 2);
+    out.push_back(0);
+    std::size_t code_pos = 0;
+    uint8_t code = 1;
+    for (std::size_t pos = 0; pos < total; ++pos) {
+        const auto value = pos < size ? data[pos] : sum[pos - size];
+        if (value) {
+            out.push_back(value);
+            if (++code < 0xff) continue;
+        }
+        out[code_pos] = code;
+        code_pos = out.size();
+        out.push_back(0);
+        code = 1;
+    }
+    out[code_pos] = code;
+    out.push_back(0);
+    return out.size();
+}
+
+inline auto length_encode(const uint8_t *data, std::size_t size, std::vector<uint8_t>& out, std::size_t header = 2, frame_crc crc = frame_crc::none) {
+    const auto length = size + crc_size(crc);
+    out.clear();
+    if ((header != 1 && header != 2 && header != 4) || (header < 4 && length >= (std::size_t(1) << (header * 8)))) return std::size_t(0);
+    out.resize(header + length);
+    for (std::size_t pos = 0; pos < header; ++pos)
+        out[pos] = uint8_t(length >> ((header - pos - 1) * 8));
+    if (size)
+        memcpy(out.data() + header, data, size);
+    detail::frame_append(crc, data, size, out.data() + header + size);
+    return out.size();
+}
+
+// Fails with 0 if the delimiter would appear before the end of the frame.
+inline auto delimiter_encode(const uint8_t *data, std::size_t size, std::vector<uint8_t>& out, std::string_view delim = "\n", frame_crc crc = frame_crc::none) {
+    const auto bytes = crc_size(crc) * 2;
+    out.resize(size + bytes + delim.size());
+    if (size)
+        memcpy(out.data(), data, size);
+    detail::frame_append_hex(crc, data, size, out.data() + size);
+    memcpy(out.data() + size + bytes, delim.data(), delim.size());
+    const auto text = std::string_view(reinterpret_cast<const char *>(out.data()), out.size());
+    if (delim.empty() || text.find(delim) != size + bytes) {
+        out.clear();
+        return std::size_t(0);
+    }
+    return out.size();
+}
+
+inline auto put_frame(const serial_t& sio, const std::vector<uint8_t>& frame) {
+    return !frame.empty() && sio.put(frame.data(), frame.size()) == frame.size();
+}
 } // namespace tycho
 #endif
@@ -4,9 +4,15 @@
 #ifndef TYCHO_SIGN_HPP_
 #define TYCHO_SIGN_HPP_
 
+#include "tasks.hpp"
+
 #include <string>
 #include <memory.hpp>
 #include <string_view>
+#include <mutex>
+#include <list>
+#include <vector>
+#include <map>
 #include <openssl/ec.h>
 #include <openssl/evp.h>
 #include <openssl/pem.h>
@@ -47,20 +53,27 @@ public:
         EVP_PKEY_CTX_free(ctx);
     }
 
-    explicit pubkey_t(const key_t key, const std::string& curve = "secp521r1") noexcept : key_(EVP_EC_gen(curve.c_str())) {
-        if (!key_) return;
+    explicit pubkey_t(const key_t key, const std::string& curve = "secp521r1") noexcept {
         OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_PKEY_PARAM_GROUP_NAME, const_cast<char *>(curve.c_str()), 0),
         OSSL_PARAM_construct_octet_string(OSSL_PKEY_PARAM_PUB_KEY, const_cast<uint8_t *>(key.first), key.second),
         OSSL_PARAM_construct_end()};
 
-        auto ctx = EVP_PKEY_CTX_new(key_, nullptr);
-        EVP_PKEY_fromdata_init(ctx);
-        EVP_PKEY_fromdata(ctx, &key_, EVP_PKEY_PUBLIC_KEY, params);
+        if (is_raw(curve)) {
+            key_ = EVP_PKEY_new_raw_public_key_ex(nullptr, curve.c_str(), nullptr, key.first, key.second);
+            return;
+        }
+
+        auto ctx = EVP_PKEY_CTX_new_from_name(nullptr, "EC", nullptr);
+        if (!ctx) return;
+        if (EVP_PKEY_fromdata_init(ctx) != 1 || EVP_PKEY_fromdata(ctx, &key_, EVP_PKEY_PUBLIC_KEY, params) != 1)
+            key_ = nullptr;
         EVP_PKEY_CTX_free(ctx);
     }
 
     pubkey_t(const pubkey_t& other) noexcept : key_(other.key_) {
-        EVP_PKEY_up_ref(key_);
+        if (key_)
+            EVP_PKEY_up_ref(key_);
     }
 
     ~pubkey_t() {
@@ -86,7 +99,8 @@ public:
         if (key_)
             EVP_PKEY_free(key_);
         key_ = other.key_;
-        EVP_PKEY_up_ref(key_);
+        if (key_)
+            EVP_PKEY_up_ref(key_);
         return *this;
     }
 
@@ -96,10 +110,26 @@ public:
         return key_;
     }
 
+    // borrowed, no reference taken
+    auto get() const noexcept -> EVP_PKEY * {
+        return key_;
+    }
+
+    static auto is_raw(const std::string& curve) noexcept -> bool {
+        return curve == "ED25519" || curve == "ED448" || curve == "X25519" || curve == "X448";
+    }
+
 private:
     EVP_PKEY *key_{nullptr};
 };
 
+// ed25519 and ed448 sign the whole message at once, without a digest
+inline auto is_oneshot(EVP_PKEY *key) noexcept -> bool {
+    if (!key) return false;
+    const auto id = EVP_PKEY_get_id(key);
+    return id == EVP_PKEY_ED25519 || id == EVP_PKEY_ED448;
+}
+
 class sign_t final {
 public:
     explicit sign_t(EVP_PKEY *key, const EVP_MD *md = EVP_sha256()) noexcept : key_(key) {
@@ -107,13 +137,16 @@ public:
             ctx_ = EVP_MD_CTX_new();
 
         if (!ctx_) return;
-        EVP_DigestSignInit(ctx_, nullptr, md, nullptr, key_);
+        oneshot_ = is_oneshot(key_);
+        EVP_DigestSignInit(ctx_, nullptr, oneshot_ ? nullptr : md, nullptr, key_);
     }
 
     sign_t(sign_t&& other) noexcept {
         if (this == &other) return;
         ctx_ = other.ctx_;
         key_ = other.key_;
+        oneshot_ = other.oneshot_;
+        message_ = std::move(other.message_);
         other.key_ = nullptr;
         other.ctx_ = nullptr;
     }
@@ -149,7 +182,12 @@ public:
     }
 
     auto update(const uint8_t *data, std::size_t size) noexcept {
-        return !ctx_ ? false : EVP_DigestSignUpdate(ctx_, data, size) > 0;
+        if (!ctx_) return false;
+        if (oneshot_) {
+            message_.append(reinterpret_cast<const char *>(data), size);
+            return true;
+        }
+        return EVP_DigestSignUpdate(ctx_, data, size) > 0;
     }
 
     auto update(const std::string_view& view) noexcept {
@@ -158,14 +196,21 @@ public:
 
     auto finish() noexcept {
         if (!ctx_ || size_ > 0) return false;
-        return EVP_DigestSignFinal(ctx_, data_, &size_) > 0;
+        size_ = sizeof(data_);
+        const auto msg = reinterpret_cast<const uint8_t *>(message_.data());
+        if (oneshot_ && EVP_DigestSign(ctx_, data_, &size_, msg, message_.size()) > 0) return true;
+        if (!oneshot_ && EVP_DigestSignFinal(ctx_, data_, &size_) > 0) return true;
+        size_ = 0;
+        return false;
     }
 
 private:
     EVP_MD_CTX *ctx_{nullptr};
     EVP_PKEY *key_{nullptr};
     std::size_t size_{0};
-    uint8_t data_[EVP_MAX_MD_SIZE]{};
+    uint8_t data_[256]{}; // der ecdsa signatures exceed EVP_MAX_MD_SIZE
+    std::string message_;
+    bool oneshot_{false};
 };
 
 class verify_t final {
@@ -175,13 +220,16 @@ public:
             ctx_ = EVP_MD_CTX_new();
 
         if (!ctx_) return;
-        EVP_DigestVerifyInit(ctx_, nullptr, md, nullptr, key_);
+        oneshot_ = is_oneshot(key_);
+        EVP_DigestVerifyInit(ctx_, nullptr, oneshot_ ? nullptr : md, nullptr, key_);
     }
 
     verify_t(verify_t&& other) noexcept {
         if (this == &other) return;
         ctx_ = other.ctx_;
         key_ = other.key_;
+        oneshot_ = other.oneshot_;
+        message_ = std::move(other.message_);
         other.key_ = nullptr;
         other.ctx_ = nullptr;
     }
@@ -206,7 +254,12 @@ public:
     }
 
     auto update(const uint8_t *data, std::size_t size) noexcept {
-        return !ctx_ ? false : EVP_DigestVerifyUpdate(ctx_, data, size) > 0;
+        if (!ctx_) return false;
+        if (oneshot_) {
+            message_.append(reinterpret_cast<const char *>(data), size);
+            return true;
+        }
+        return EVP_DigestVerifyUpdate(ctx_, data, size) > 0;
     }
 
     auto update(const std::string_view& view) noexcept {
@@ -214,12 +267,117 @@ public:
     }
 
     auto finish(const uint8_t *sign, std::size_t size) noexcept {
-        return !ctx_ ? false : EVP_DigestVerifyFinal(ctx_, sign, size) == 1;
+        if (!ctx_) return false;
+        if (oneshot_) return EVP_DigestVerify(ctx_, sign, size, reinterpret_cast<const uint8_t *>(message_.data()), message_.size()) == 1;
+        return EVP_DigestVerifyFinal(ctx_, sign, size) == 1;
     }
 
 private:
     EVP_MD_CTX *ctx_{nullptr};
     EVP_PKEY *key_{nullptr};
+    std::string message_;
+    bool oneshot_{false};
+};
+
+enum class verified : uint8_t { skipped = 0, valid, invalid };
+
+struct verify_item final {
+    EVP_PKEY *key{nullptr}; // borrowed
+    key_t message{nullptr, 0};
+    key_t signature{nullptr, 0};
+};
+
+// one shot verify with a per-thread context re-used between calls
+inline auto verify(EVP_PKEY *key, const key_t& message, const key_t& signature, const EVP_MD *md = EVP_sha256()) noexcept {
+    struct context_t final {
+        EVP_MD_CTX *ctx{EVP_MD_CTX_new()};
+        ~context_t() {
+            if (ctx)
+                EVP_MD_CTX_free(ctx);
+        }
+    };
+
+    thread_local context_t local;
+    if (!key || !local.ctx) return false;
+    EVP_MD_CTX_reset(local.ctx);
+    if (EVP_DigestVerifyInit(local.ctx, nullptr, is_oneshot(key) ? nullptr : md, nullptr, key) != 1) return false;
+    return EVP_DigestVerify(local.ctx, signature.first, signature.second, message.first, message.second) == 1;
+}
+
+// per-item results, items after a failure are skipped if fail_fast is set
+inline auto verify_batch(const std::vector<verify_item>& items, task_pool& pool, bool fail_fast = false, const EVP_MD *md = EVP_sha256()) {
+    std::vector<verified> results(items.size(), verified::skipped);
+    parallel_for(pool, items.size(), [&](std::size_t index) {
+        const auto& item = items[index];
+        const auto ok = verify(item.key, item.message, item.signature, md);
+        results[index] = ok ? verified::valid : verified::invalid;
+        return ok || !fail_fast;
+    });
+    return results;
+}
+
+// raw peer public keys parsed once and shared, bounded by limit with the
+// least recently used key dropped first
+class pubkey_cache final {
+public:
+    explicit pubkey_cache(std::string curve = "secp521r1", std::size_t limit = 1024) : curve_(std::move(curve)), limit_(limit ? limit : 1) {}
+    pubkey_cache(const pubkey_cache&) = delete;
+    auto operator=(const pubkey_cache&) -> auto& = delete;
+
+    auto get(const key_t& raw) -> pubkey_t {
+        const std::string_view id(reinterpret_cast<const char *>(raw.first), raw.second);
+        std::unique_lock lock(lock_);
+        auto it = index_.find(id);
+        if (it != index_.end()) {
+            keys_.splice(keys_.begin(), keys_, it->second);
+            ++hits_;
+            return it->second->second;
+        }
+
+        lock.unlock();
+        const pubkey_t key(raw, curve_);
+        if (!key) return key;
+        lock.lock();
+        it = index_.find(id);
+        if (it != index_.end()) return it->second->second;
+        keys_.emplace_front(std::string(id), key);
+        index_[keys_.front().first] = keys_.begin();
+        if (keys_.size() > limit_) {
+            index_.erase(keys_.back().first);
+            keys_.pop_back();
+        }
+        return key;
+    }
+
+    void clear() noexcept {
+        const std::lock_guard lock(lock_);
+        index_.clear();
+        keys_.clear();
+    }
+
+    auto size() const noexcept {
+        const std::lock_guard lock(lock_);
+        return keys_.size();
+    }
+
+    auto hits() const noexcept {
+        const std::lock_guard lock(lock_);
+        return hits_;
+    }
+
+    auto limit() const noexcept {
+        return limit_;
+    }
+
+private:
+    using list_t = std::list<std::pair<std::string, pubkey_t>>;
+
+    std::string curve_;
+    std::size_t limit_{1024};
+    std::size_t hits_{0};
+    list_t keys_;
+    std::map<std::string_view, list_t::iterator> index_; // views into keys_
+    mutable std::mutex lock_;
 };
 } // namespace tycho::crypto
 #endif
@@ -4,6 +4,8 @@
 #ifndef TYCHO_STRINGS_HPP_
 #define TYCHO_STRINGS_HPP_
 
+#include "array.hpp"
+
 #include <type_traits>
 #include <string>
 #include <string_view>
@@ -16,6 +18,11 @@
 #include <algorithm>
 #include <set>
 #include <sstream>
+#include <iterator>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
 
 namespace tycho {
 template <typename T>
@@ -40,34 +47,156 @@ constexpr auto promoted_string(T str) -> std::enable_if_t<!is_char_pointer<T>::v
     return str;
 }
 
-inline auto begins_case(const std::string_view s, const std::string_view b) {
-    auto size = b.size();
-    if (!size) return false;
-    if (s.size() < size) return false;
-    auto fp = s.data();
-    auto tp = b.data();
+namespace detail {
+constexpr auto ascii_lower(char c) noexcept {
+    return char(c ^ ((unsigned(uint8_t(c) - 'A') < 26U) << 5));
+}
+
+inline auto eq_case(const char *s1, const char *s2, std::size_t size) noexcept {
     while (size--) {
-        if ((*fp != *tp) && (tolower(*fp) != *tp)) return false;
-        ++fp;
-        ++tp;
+        if (ascii_lower(*(s1++)) != ascii_lower(*(s2++))) return false;
     }
     return true;
 }
 
-inline auto ends_case(const std::string_view s, const std::string_view e) {
-    auto size = e.size();
-    if (!size) return false;
-    if (s.size() < size) return false;
-    auto fp = s.data() + s.size() - size;
-    auto tp = e.data();
-    while (size--) {
-        if ((*fp != *tp) && (tolower(*fp) != *tp)) return false;
-        ++fp;
-        ++tp;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TYCHO_STRINGS_X86
+
+inline auto cpu_ssse3() noexcept {
+    static const bool ssse3 = __builtin_cpu_supports("ssse3");
+    return ssse3;
+}
+
+inline auto cpu_avx2() noexcept {
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+
+// sse2 is part of the x86_64 baseline, so needs no dispatch
+inline auto flip128(__m128i text, char from) noexcept {
+    const auto above = _mm_cmpgt_epi8(text, _mm_set1_epi8(char(from - 1)));
+    const auto below = _mm_cmplt_epi8(text, _mm_set1_epi8(char(from + 26)));
+    return _mm_xor_si128(text, _mm_and_si128(_mm_and_si128(above, below), _mm_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2"))) inline auto flip256(__m256i text, char from) noexcept {
+    const auto above = _mm256_cmpgt_epi8(text, _mm256_set1_epi8(char(from - 1)));
+    const auto below = _mm256_cmpgt_epi8(_mm256_set1_epi8(char(from + 26)), text);
+    return _mm256_xor_si256(text, _mm256_and_si256(_mm256_and_si256(above, below), _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2"))) inline auto case_avx2(char *data, std::size_t size, char from) noexcept {
+    std::size_t pos = 0;
+    for (; pos + 32 <= size; pos += 32) {
+        auto text = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + pos), flip256(text, from));
+    }
+    return pos;
+}
+
+inline auto case_sse2(char *data, std::size_t size, char from) noexcept {
+    std::size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        auto text = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + pos), flip128(text, from));
+    }
+    return pos;
+}
+
+__attribute__((target("avx2"))) inline auto eq_case_avx2(const char *s1, const char *s2, std::size_t size, std::size_t& pos) noexcept {
+    for (; pos + 32 <= size; pos += 32) {
+        auto t1 = flip256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s1 + pos)), 'A');
+        auto t2 = flip256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(s2 + pos)), 'A');
+        if (uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(t1, t2))) != 0xffffffffU) return false;
+    }
+    return true;
+}
+
+inline auto eq_case_sse2(const char *s1, const char *s2, std::size_t size, std::size_t& pos) noexcept {
+    for (; pos + 16 <= size; pos += 16) {
+        auto t1 = flip128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s1 + pos)), 'A');
+        auto t2 = flip128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s2 + pos)), 'A');
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(t1, t2)) != 0xffff) return false;
     }
     return true;
 }
 
+// candidates match the folded first and last needle byte, then verify
+inline auto find_case_sse2(const char *text, std::size_t size, const char *find, std::size_t count, std::size_t& pos) noexcept {
+    const auto first = _mm_set1_epi8(ascii_lower(find[0]));
+    const auto last = _mm_set1_epi8(ascii_lower(find[count - 1]));
+    for (; pos + count - 1 + 16 <= size; pos += 16) {
+        auto head = flip128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(text + pos)), 'A');
+        auto tail = flip128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(text + pos + count - 1)), 'A');
+        auto mask = unsigned(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, first), _mm_cmpeq_epi8(tail, last))));
+        while (mask) {
+            auto bit = std::size_t(__builtin_ctz(mask));
+            if (count < 3 || eq_case(text + pos + bit + 1, find + 1, count - 2)) return pos + bit;
+            mask &= mask - 1;
+        }
+    }
+    return std::string_view::npos;
+}
+#endif
+
+inline void fold_case(char *data, std::size_t size, char from) noexcept {
+    std::size_t pos = 0;
+#ifdef TYCHO_STRINGS_X86
+    if (size >= 32 && cpu_avx2())
+        pos = case_avx2(data, size, from);
+    pos += case_sse2(data + pos, size - pos, from);
+#endif
+    for (; pos < size; ++pos)
+        data[pos] = char(data[pos] ^ ((unsigned(uint8_t(data[pos]) - uint8_t(from)) < 26U) << 5));
+}
+} // namespace detail
+
+// ASCII only case mapping in place; other bytes are left untouched
+inline void ascii_upper(char *data, std::size_t size) noexcept {
+    detail::fold_case(data, size, 'a');
+}
+
+inline void ascii_lower(char *data, std::size_t size) noexcept {
+    detail::fold_case(data, size, 'A');
+}
+
+inline auto eq_case(const std::string_view s1, const std::string_view s2) noexcept {
+    if (s1.size() != s2.size()) return false;
+    std::size_t pos = 0;
+#ifdef TYCHO_STRINGS_X86
+    if (s1.size() >= 32 && detail::cpu_avx2() && !detail::eq_case_avx2(s1.data(), s2.data(), s1.size(), pos)) return false;
+    if (!detail::eq_case_sse2(s1.data(), s2.data(), s1.size(), pos)) return false;
+#endif
+    return detail::eq_case(s1.data() + pos, s2.data() + pos, s1.size() - pos);
+}
+
+inline auto find_case(const std::string_view s, const std::string_view find, std::size_t pos = 0) noexcept {
+    if (pos > s.size() || find.size() > s.size() - pos) return std::string_view::npos;
+    if (find.empty()) return pos;
+#ifdef TYCHO_STRINGS_X86
+    auto found = detail::find_case_sse2(s.data(), s.size(), find.data(), find.size(), pos);
+    if (found != std::string_view::npos) return found;
+#endif
+    for (; pos + find.size() <= s.size(); ++pos) {
+        if (detail::eq_case(s.data() + pos, find.data(), find.size())) return pos;
+    }
+    return std::string_view::npos;
+}
+
+inline auto contains_case(const std::string_view s, const std::string_view c) noexcept {
+    return find_case(s, c) != std::string_view::npos;
+}
+
+inline auto begins_case(const std::string_view s, const std::string_view b) {
+    if (b.empty() || s.size() < b.size()) return false;
+    return eq_case(s.substr(0, b.size()), b);
+}
+
+inline auto ends_case(const std::string_view s, const std::string_view e) {
+    if (e.empty() || s.size() < e.size()) return false;
+    return eq_case(s.substr(s.size() - e.size()), e);
+}
+
 constexpr auto contains(const std::string_view s, const std::string_view c) {
     return s.find(c) <= s.size();
 }
@@ -85,13 +214,13 @@ constexpr auto ends_with(const std::string_view s, const std::string_view e) {
 
 inline auto upper_case(const std::string_view s) {
     auto out = std::string{s};
-    std::transform(out.begin(), out.end(), out.begin(), ::toupper);
+    ascii_upper(out.data(), out.size());
     return out;
 }
 
 inline auto lower_case(const std::string_view s) {
     auto out = std::string{s};
-    std::transform(out.begin(), out.end(), out.begin(), ::tolower);
+    ascii_lower(out.data(), out.size());
     return out;
 }
 
@@ -202,6 +331,202 @@ inline auto tokenize(const S& str, std::string_view delim = " ", std::string_vie
     return result;
 }
 
+// Lazy forms of split and tokenize; fields are views into the source.
+class split_range final {
+public:
+    class iterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+
+        auto operator*() const noexcept -> reference {
+            return field_;
+        }
+
+        auto operator->() const noexcept -> pointer {
+            return &field_;
+        }
+
+        auto operator++() noexcept -> iterator& {
+            if (next_ == std::string_view::npos)
+                range_ = nullptr;
+            else
+                find(next_);
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> iterator {
+            auto prior = *this;
+            ++*this;
+            return prior;
+        }
+
+        auto operator==(const iterator& other) const noexcept {
+            return range_ == other.range_ && (!range_ || field_.data() == other.field_.data());
+        }
+
+        auto operator!=(const iterator& other) const noexcept {
+            return !(*this == other);
+        }
+
+    private:
+        friend class split_range;
+
+        const split_range *range_{nullptr};
+        std::string_view field_;
+        std::size_t next_{0};
+        unsigned count_{0};
+
+        explicit iterator(const split_range *range) noexcept : range_(range) {
+            find(0);
+        }
+
+        void find(std::size_t from) noexcept {
+            const auto& str = range_->str_;
+            next_ = std::string_view::npos;
+            if (!range_->max_ || ++count_ < range_->max_)
+                next_ = str.find_first_of(range_->delim_, from);
+            if (next_ == std::string_view::npos) {
+                field_ = str.substr(from);
+                return;
+            }
+            field_ = str.substr(from, next_++ - from);
+        }
+    };
+
+    split_range(std::string_view str, std::string_view delim, unsigned max = 0) noexcept : str_(str), delim_(delim), max_(max) {}
+
+    auto begin() const noexcept {
+        return iterator(this);
+    }
+
+    auto end() const noexcept {
+        return iterator();
+    }
+
+private:
+    std::string_view str_, delim_;
+    unsigned max_;
+};
+
+class token_range final {
+public:
+    class iterator final {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view *;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+
+        auto operator*() const noexcept -> reference {
+            return token_;
+        }
+
+        auto operator->() const noexcept -> pointer {
+            return &token_;
+        }
+
+        auto operator++() noexcept -> iterator& {
+            find(token_.data() - range_->str_.data() + token_.size());
+            return *this;
+        }
+
+        auto operator++(int) noexcept -> iterator {
+            auto prior = *this;
+            ++*this;
+            return prior;
+        }
+
+        auto operator==(const iterator& other) const noexcept {
+            return range_ == other.range_ && (!range_ || token_.data() == other.token_.data());
+        }
+
+        auto operator!=(const iterator& other) const noexcept {
+            return !(*this == other);
+        }
+
+    private:
+        friend class token_range;
+
+        const token_range *range_{nullptr};
+        std::string_view token_;
+
+        explicit iterator(const token_range *range) noexcept : range_(range) {
+            find(0);
+        }
+
+        // quoted tokens run to their closing quote, as in tokenize
+        void find(std::size_t from) noexcept {
+            const auto& str = range_->str_;
+            auto start = str.find_first_not_of(range_->delim_, from);
+            if (start == std::string_view::npos) {
+                range_ = nullptr;
+                token_ = {};
+                return;
+            }
+
+            auto lead = range_->quotes_.find(str[start]);
+            if (lead != std::string_view::npos && !(lead & 0x01) && lead + 1 < range_->quotes_.size()) {
+                auto tail = str.find(range_->quotes_[lead + 1], start + 1);
+                if (tail != std::string_view::npos) {
+                    token_ = str.substr(start, tail - start + 1);
+                    return;
+                }
+            }
+            auto tail = str.find_first_of(range_->delim_, start);
+            token_ = str.substr(start, tail == std::string_view::npos ? tail : tail - start);
+        }
+    };
+
+    token_range(std::string_view str, std::string_view delim, std::string_view quotes) noexcept : str_(str), delim_(delim), quotes_(quotes) {}
+
+    auto begin() const noexcept {
+        return iterator(this);
+    }
+
+    auto end() const noexcept {
+        return iterator();
+    }
+
+private:
+    std::string_view str_, delim_, quotes_;
+};
+
+inline auto split_view(std::string_view str, std::string_view delim = " ", unsigned max = 0) noexcept {
+    return split_range(str, delim, max);
+}
+
+inline auto tokenize_view(std::string_view str, std::string_view delim = " ", std::string_view quotes = R"(""''{})") noexcept {
+    return token_range(str, delim, quotes);
+}
+
+// Fixed field split; the last slot receives the unsplit remainder.
+inline auto split_into(std::string_view str, span<std::string_view> fields, std::string_view delim = " ") noexcept {
+    std::size_t count = 0;
+    if (!fields.size()) return count;
+    for (auto field : split_range(str, delim, unsigned(std::min<std::size_t>(fields.size(), UINT32_MAX))))
+        fields.data()[count++] = field;
+    return count;
+}
+
+// Tokens past the capacity of fields are not stored; returns tokens stored.
+inline auto tokenize_into(std::string_view str, span<std::string_view> fields, std::string_view delim = " ", std::string_view quotes = R"(""''{})") noexcept {
+    std::size_t count = 0;
+    for (auto token : token_range(str, delim, quotes)) {
+        if (count >= fields.size()) break;
+        fields.data()[count++] = token;
+    }
+    return count;
+}
+
 constexpr auto is_line(const std::string_view str) {
     if (str.empty()) return false;
     if (str[str.size() - 1] == '\n') return true;
@@ -316,5 +641,196 @@ constexpr auto u8verify(const std::string_view& u8) noexcept {
     }
     return true;
 }
+
+namespace detail {
+// strict utf-8 per unicode table 3-7, no overlongs or surrogates
+inline auto u8valid_scalar(const uint8_t *text, std::size_t size) noexcept {
+    std::size_t pos = 0;
+    while (pos < size) {
+        if (pos + 8 <= size) {
+            uint64_t word{0};
+            memcpy(&word, text + pos, sizeof(word));
+            if (!(word & UINT64_C(0x8080808080808080))) {
+                pos += 8;
+                continue;
+            }
+        }
+        auto lead = text[pos++];
+        if (lead < 0x80) continue;
+        uint8_t low = 0x80, high = 0xbf;
+        std::size_t more = 0;
+        if (lead >= 0xc2 && lead <= 0xdf)
+            more = 1;
+        else if (lead >= 0xe0 && lead <= 0xef) {
+            more = 2;
+            if (lead == 0xe0) low = 0xa0;
+            if (lead == 0xed) high = 0x9f;
+        }
+        else if (lead >= 0xf0 && lead <= 0xf4) {
+            more = 3;
+            if (lead == 0xf0) low = 0x90;
+            if (lead == 0xf4) high = 0x8f;
+        }
+        else
+            return false;
+
+        if (size - pos < more) return false;
+        if (text[pos] < low || text[pos] > high) return false;
+        while (--more) {
+            if ((text[++pos] & 0xc0) != 0x80) return false;
+        }
+        ++pos;
+    }
+    return true;
+}
+
+#ifdef TYCHO_STRINGS_X86
+// Keiser and Lemire lookup validation; each bit names a class of error
+// that the two nibbles of the previous byte and high nibble of the
+// current byte must all agree on.
+enum : uint8_t {
+    u8_too_short = 1 << 0,
+    u8_too_long = 1 << 1,
+    u8_overlong_3 = 1 << 2,
+    u8_too_large = 1 << 3,
+    u8_surrogate = 1 << 4,
+    u8_overlong_2 = 1 << 5,
+    u8_too_large_1000 = 1 << 6,
+    u8_overlong_4 = 1 << 6,
+    u8_two_conts = 1 << 7,
+    u8_carry = u8_too_short | u8_too_long | u8_two_conts,
+};
+
+#define TYCHO_U8_HIGH1                                                                             \
+    u8_too_long, u8_too_long, u8_too_long, u8_too_long, u8_too_long, u8_too_long, u8_too_long,     \
+        u8_too_long, u8_two_conts, u8_two_conts, u8_two_conts, u8_two_conts,                       \
+        u8_too_short | u8_overlong_2, u8_too_short, u8_too_short | u8_overlong_3 | u8_surrogate, \
+        u8_too_short | u8_too_large | u8_too_large_1000 | u8_overlong_4
+
+#define TYCHO_U8_LOW1                                                                                                  \
+    u8_carry | u8_overlong_3 | u8_overlong_2 | u8_overlong_4, u8_carry | u8_overlong_2, u8_carry, u8_carry,        \
+        u8_carry | u8_too_large, u8_carry | u8_too_large | u8_too_large_1000, u8_carry | u8_too_large | u8_too_large_1000, \
+        u8_carry | u8_too_large | u8_too_large_1000, u8_carry | u8_too_large | u8_too_large_1000,                \
+        u8_carry | u8_too_large | u8_too_large_1000, u8_carry | u8_too_large | u8_too_large_1000,                \
+        u8_carry | u8_too_large | u8_too_large_1000, u8_carry | u8_too_large | u8_too_large_1000,                \
+        u8_carry | u8_too_large | u8_too_large_1000 | u8_surrogate, u8_carry | u8_too_large | u8_too_large_1000,  \
+        u8_carry | u8_too_large | u8_too_large_1000
+
+#define TYCHO_U8_HIGH2                                                                                                     \
+    u8_too_short, u8_too_short, u8_too_short, u8_too_short, u8_too_short, u8_too_short, u8_too_short, u8_too_short,       \
+        u8_too_long | u8_overlong_2 | u8_two_conts | u8_overlong_3 | u8_too_large_1000 | u8_overlong_4,                 \
+        u8_too_long | u8_overlong_2 | u8_two_conts | u8_overlong_3 | u8_too_large,                                      \
+        u8_too_long | u8_overlong_2 | u8_two_conts | u8_surrogate | u8_too_large,                                       \
+        u8_too_long | u8_overlong_2 | u8_two_conts | u8_surrogate | u8_too_large, u8_too_short, u8_too_short,         \
+        u8_too_short, u8_too_short
+
+__attribute__((target("ssse3"))) inline auto u8check128(__m128i input, __m128i prior) noexcept {
+    const auto nibble = _mm_set1_epi8(0x0f);
+    const auto prev1 = _mm_alignr_epi8(input, prior, 15);
+    const auto high1 = _mm_shuffle_epi8(_mm_setr_epi8(TYCHO_U8_HIGH1), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const auto low1 = _mm_shuffle_epi8(_mm_setr_epi8(TYCHO_U8_LOW1), _mm_and_si128(prev1, nibble));
+    const auto high2 = _mm_shuffle_epi8(_mm_setr_epi8(TYCHO_U8_HIGH2), _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const auto special = _mm_and_si128(_mm_and_si128(high1, low1), high2);
+    const auto third = _mm_subs_epu8(_mm_alignr_epi8(input, prior, 14), _mm_set1_epi8(char(0xe0 - 0x80)));
+    const auto fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prior, 13), _mm_set1_epi8(char(0xf0 - 0x80)));
+    const auto must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+    return _mm_xor_si128(must23, special);
+}
+
+__attribute__((target("ssse3"))) inline auto u8incomplete128(__m128i input) noexcept {
+    const auto max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xf0 - 1), char(0xe0 - 1), char(0xc0 - 1));
+    return _mm_subs_epu8(input, max);
+}
+
+__attribute__((target("ssse3"))) inline auto u8valid_ssse3(const uint8_t *text, std::size_t size) noexcept {
+    auto error = _mm_setzero_si128();
+    auto prior = _mm_setzero_si128();
+    auto incomplete = _mm_setzero_si128();
+    for (std::size_t pos = 0;; pos += 16) {
+        __m128i input{};
+        if (pos + 16 <= size)
+            input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + pos));
+        else {
+            // zero padding is ascii, so flags any sequence cut short
+            uint8_t last[16]{};
+            memcpy(last, text + pos, size - pos);
+            input = _mm_loadu_si128(reinterpret_cast<const __m128i *>(last));
+        }
+        if (!_mm_movemask_epi8(input)) {
+            error = _mm_or_si128(error, incomplete);
+            incomplete = _mm_setzero_si128();
+        }
+        else {
+            error = _mm_or_si128(error, u8check128(input, prior));
+            incomplete = u8incomplete128(input);
+        }
+        if (pos + 16 > size) break;
+        prior = input;
+    }
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xffff;
+}
+
+__attribute__((target("avx2"))) inline auto u8check256(__m256i input, __m256i prior) noexcept {
+    const auto nibble = _mm256_set1_epi8(0x0f);
+    const auto carry = _mm256_permute2x128_si256(prior, input, 0x21);
+    const auto prev1 = _mm256_alignr_epi8(input, carry, 15);
+    const auto high1 = _mm256_shuffle_epi8(_mm256_setr_epi8(TYCHO_U8_HIGH1, TYCHO_U8_HIGH1), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const auto low1 = _mm256_shuffle_epi8(_mm256_setr_epi8(TYCHO_U8_LOW1, TYCHO_U8_LOW1), _mm256_and_si256(prev1, nibble));
+    const auto high2 = _mm256_shuffle_epi8(_mm256_setr_epi8(TYCHO_U8_HIGH2, TYCHO_U8_HIGH2), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const auto special = _mm256_and_si256(_mm256_and_si256(high1, low1), high2);
+    const auto third = _mm256_subs_epu8(_mm256_alignr_epi8(input, carry, 14), _mm256_set1_epi8(char(0xe0 - 0x80)));
+    const auto fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, carry, 13), _mm256_set1_epi8(char(0xf0 - 0x80)));
+    const auto must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+    return _mm256_xor_si256(must23, special);
+}
+
+__attribute__((target("avx2"))) inline auto u8incomplete256(__m256i input) noexcept {
+    const auto max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xf0 - 1), char(0xe0 - 1), char(0xc0 - 1));
+    return _mm256_subs_epu8(input, max);
+}
+
+__attribute__((target("avx2"))) inline auto u8valid_avx2(const uint8_t *text, std::size_t size) noexcept {
+    auto error = _mm256_setzero_si256();
+    auto prior = _mm256_setzero_si256();
+    auto incomplete = _mm256_setzero_si256();
+    for (std::size_t pos = 0;; pos += 32) {
+        __m256i input{};
+        if (pos + 32 <= size)
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + pos));
+        else {
+            uint8_t last[32]{};
+            memcpy(last, text + pos, size - pos);
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(last));
+        }
+        if (!_mm256_movemask_epi8(input)) {
+            error = _mm256_or_si256(error, incomplete);
+            incomplete = _mm256_setzero_si256();
+        }
+        else {
+            error = _mm256_or_si256(error, u8check256(input, prior));
+            incomplete = u8incomplete256(input);
+        }
+        if (pos + 32 > size) break;
+        prior = input;
+    }
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+#undef TYCHO_U8_HIGH1
+#undef TYCHO_U8_LOW1
+#undef TYCHO_U8_HIGH2
+#endif
+} // namespace detail
+
+// Strict utf-8 validation, unlike u8verify; rejects overlong forms,
+// surrogates, and code points past U+10FFFF, and accepts embedded nul.
+inline auto u8valid(const std::string_view u8) noexcept {
+    auto text = reinterpret_cast<const uint8_t *>(u8.data());
+#ifdef TYCHO_STRINGS_X86
+    if (u8.size() >= 32 && detail::cpu_avx2()) return detail::u8valid_avx2(text, u8.size());
+    if (u8.size() >= 16 && detail::cpu_ssse3()) return detail::u8valid_ssse3(text, u8.size());
+#endif
+    return detail::u8valid_scalar(text, u8.size());
+}
 } // namespace tycho
 #endif
@@ -571,6 +571,34 @@ protected:
     }
 };
 
+// run func(index) for each index in [0, count) spread over pool workers and
+// wait. Stops early and returns false once any func returns false. Should
+// not be called from a worker of the same pool.
+template <typename Func>
+inline auto parallel_for(task_pool& pool, std::size_t count, Func func) -> bool {
+    std::atomic<bool> result{true};
+    std::mutex lock;
+    std::condition_variable done;
+    const auto jobs = std::min(count, std::max(pool.size(), std::size_t(1)));
+    auto pending = jobs;
+    for (std::size_t job = 0; job < jobs; ++job) {
+        auto task = [&, job] {
+            for (auto index = job; index < count && result; index += jobs) {
+                if (!func(index))
+                    result = false;
+            }
+            const std::lock_guard guard(lock);
+            if (--pending == 0)
+                done.notify_all();
+        };
+        if (!pool.dispatch(task))
+            task();
+    }
+    std::unique_lock guard(lock);
+    done.wait(guard, [&] { return pending == 0; });
+    return result.load();
+}
+
 inline void parallel_task(std::size_t count, task_t task) {
     if (!count)
         count = std::thread::hardware_concurrency();
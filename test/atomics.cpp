@@ -8,6 +8,8 @@
 
 #include <cstdint>
 #include <string>
+#include <thread>
+#include <vector>
 
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     const atomic::once_t once;
@@ -35,6 +37,35 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     });
     assert(dict.find(2).value() == "two two"); // NOLINT
 
+    atomic::interner_t names(64);
+    assert(!names && !names.find("host"));
+    std::string key = "content-type";
+    auto type = names.intern(key);
+    key[0] = 'x';
+    assert(type.view() == "content-type" && type.id() == 0);
+    assert(names("content-type") == type);
+    assert(names.find("content-type").c_str() == type.c_str());
+    assert(names.intern("host") != type && names.size() == 2);
+    assert(names.view("host").data() == names.view(std::string("host")).data());
+    assert(names.intern(std::string(1U << 20, 'x')).size() == 0);
+
+    std::vector<std::thread> workers;
+    std::vector<atomic::symbol_t> seen[4];
+    for (auto& list : seen) {
+        workers.emplace_back([&names, &list] {
+            for (unsigned pos = 0; pos < 2000; ++pos)
+                list.push_back(names.intern("key-" + std::to_string(pos % 500)));
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    assert(names.size() == 502);
+    for (unsigned pos = 0; pos < 2000; ++pos) {
+        assert(seen[0][pos] == seen[3][pos] && seen[1][pos] == seen[2][pos]);
+        assert(seen[0][pos].view() == "key-" + std::to_string(pos % 500));
+        assert(seen[0][pos].id() >= 2 && seen[0][pos].id() < 502);
+    }
+
     int value = 0;
     const tycho::atomic_ref<int> ref(value);
 
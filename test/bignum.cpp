@@ -5,6 +5,7 @@
 #include "compiler.hpp" // IWYU pragma: keep
 #include "bignum.hpp"
 #include "strings.hpp"
+#include "templates.hpp"
 
 using namespace crypto;
 
@@ -23,4 +24,121 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
 
     auto a = abs(v1);
     assert(*a == "23451234567864");
+
+    v1 = 100;
+    v1 /= bignum_t(7);
+    assert(*v1 == "14");
+    v1 %= bignum_t(4);
+    assert(*v1 == "2");
+
+    const bignum_t m(1000003), b(12345), c(7);
+    bignum_t r;
+    r.mul_add(b, b, c);
+    assert(*r == "152399032");
+    r.mod_mul(b, b, m);
+    assert(r == sqr(b) % m);
+    r.mod_sqr(b, m);
+    assert(r == sqr(b) % m);
+    r.mod_exp(b, c, m);
+    assert(r == (b ^ 7) % m);
+    r.mul_add(r, c, r);
+    assert(r == ((b ^ 7) % m) * std::size_t(8));
+
+    const modulus_t mod(m);
+    assert(is(mod));
+    const bignum_t e(65537);
+    assert(mod.mod_exp(b, e) == pow(b, e) % m);
+    assert(mod.mod_exp(b, e, true) == pow(b, e) % m);
+    assert(mod.mod_mul(b, c) == (b * c) % m);
+    assert(mod.mod_sqr(b) == sqr(b) % m);
+    assert(mod.mod_mul(mod.mod_inverse(b), b) == bignum_t(1));
+    assert(mod.mod_mul(mod.mod_inverse(b, true), b) == bignum_t(1));
+
+    const fixed_base_t gen(mod, c);
+    assert(is(gen));
+    assert(gen.exp(e) == mod.mod_exp(c, e));
+    assert(gen.exp(bignum_t(0L)) == bignum_t(1));
+    assert(gen.exp(m - std::size_t(2)) == mod.mod_exp(c, m - std::size_t(2)));
+
+    const bignum_t n(100000);
+    const modulus_t even(n);
+    assert(is(even) && !even.context());
+    assert(even.mod_mul(bignum_t(7), bignum_t(9)) == bignum_t(63));
+    assert(even.mod_mul(b, c) == (b * c) % n);
+    assert(even.mod_exp(b, e) == pow(b, e) % n);
+    assert(even.mod_exp(b, e, true) == pow(b, e) % n);
+    assert(even.from_mont(even.mont_mul(r, even.to_mont(b), even.to_mont(c))) == (b * c) % n);
+    const fixed_base_t even_gen(even, c);
+    assert(is(even_gen));
+    assert(even_gen.exp(e) == even.mod_exp(c, e));
+    assert(!modulus_t(bignum_t(0L)));
+
+    {
+        const auto max = number_t::small_max;
+        number_t a(max), one(1L);
+        assert(a.is_small());
+        auto b = a + one;
+        assert(!b.is_small());
+        assert(b.to_bignum() == a.to_bignum() + bignum_t(1L));
+        assert(*b == bignum_t(a.to_bignum() + bignum_t(1L)).to_string());
+        assert((b - one).is_small() && b - one == a);
+        assert(b > a && a < b);
+
+        auto c = a * number_t(3L);
+        assert(!c.is_small());
+        assert(c / number_t(3L) == a && (c / number_t(3L)).is_small());
+        assert(-(-c) == c);
+
+        number_t min(number_t::small_min);
+        assert(!(-min).is_small());
+        assert(!(min / number_t(-1L)).is_small());
+        assert(min % number_t(-1L) == number_t());
+
+        const number_t wide(std::numeric_limits<int64_t>::max());
+        const auto past = wide + one;
+        assert(*past == "9223372036854775808");
+        assert(past.to_bignum() == bignum_t(std::string("9223372036854775808")));
+        assert(past.is_small() == (sizeof(number_t::small_t) > 8));
+        assert(number_t(past.to_bignum()) == past && number_t(past.to_string()) == past);
+        assert(std::hash<number_t>()(past) == std::hash<bignum_t>()(past.to_bignum()));
+
+        assert(pow(number_t(3L), number_t(5L)) == number_t(243L));
+        assert(pow(number_t(2L), number_t(200L)).to_bignum() == pow(bignum_t(2L), bignum_t(200L)));
+        assert(gcd(number_t(-12L), number_t(18L)) == number_t(6L));
+        assert(abs(number_t(-7L)) == number_t(7L) && abs(-c) == c);
+        assert(sqr(number_t(-9L)) == number_t(81L));
+        assert(btol(number_t(-42L)) == -42 && btoi(number_t(1234L)) == 1234);
+
+        number_t r;
+        assert(r.mul_add(number_t(6L), number_t(7L), number_t(-2L)) == number_t(40L));
+        assert(r.mul_add(a, a, one).to_bignum() == (a.to_bignum() * a.to_bignum()) + bignum_t(1L));
+        const number_t m(1000003L);
+        assert(r.mod_add(number_t(1000000L), number_t(10L), m) == number_t(7L));
+        assert(r.mod_sub(number_t(3L), number_t(10L), m) == number_t(999996L));
+        assert(r.mod_mul(number_t(-2L), number_t(3L), m) == number_t(999997L));
+        assert(r.mod_sqr(number_t(1001L), m) == number_t(1998L));
+        assert(r.mod_exp(number_t(2L), number_t(20L), m) == number_t(48573L));
+        for (const auto& mod : {m, c, b}) {
+            bignum_t big;
+            assert(r.mod_mul(a, c, mod) == number_t(big.mod_mul(a.to_bignum(), c.to_bignum(), mod.to_bignum())));
+            assert(r.mod_exp(number_t(-5L), number_t(77L), mod) == number_t(big.mod_exp(bignum_t(-5L), bignum_t(77L), mod.to_bignum())));
+            assert(r.mod_sub(one, a, mod) == number_t(big.mod_sub(one.to_bignum(), a.to_bignum(), mod.to_bignum())));
+        }
+
+        number_t d(std::string("1234567890123456789012345678901234567890"));
+        assert(!d.is_small());
+        number_t e(std::string("-42"));
+        assert(e.is_small() && e.value() == -42);
+        e *= 2;
+        e += 4;
+        assert(*e == "-80");
+        assert(e / number_t() == number_t());
+
+        const bignum_t big(d);
+        assert(std::hash<number_t>()(d) == std::hash<bignum_t>()(big));
+        assert(std::hash<number_t>()(number_t(1234567L)) == std::hash<bignum_t>()(bignum_t(1234567)));
+        uint8_t buf[8];
+        assert(number_t(258L).put(buf, 3) == 2 && buf[0] == 1 && buf[1] == 2 && buf[2] == 0);
+        assert(number_t(258L).bits() == 9);
+    }
 }
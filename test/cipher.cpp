@@ -5,10 +5,117 @@
 #include "compiler.hpp" // IWYU pragma: keep
 #include "cipher.hpp"
 #include "encoding.hpp"
+#include "random.hpp"
+#include "tasks.hpp"
+
+#include <sstream>
+#include <vector>
 
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     const crypto::keyphrase_t key("hello there");
     assert(key.size() == 32);
     const auto pair = crypto::key_t(key);
     assert(to_b64(pair.first, pair.second) == "EpmMAXBm6w0qcLlObtMZKYWFXOOQ8yG724MgIoiL0lE=");
+
+    crypto::kdf_params pbkdf2;
+    pbkdf2.cost = 1000;
+    const crypto::salt_t salt;
+    crypto::keycache_t cache(2);
+    const auto derived = cache.get("hello there", salt, EVP_aes_256_gcm(), pbkdf2);
+    assert(derived.size() == 32);
+    assert(cache.size() == 1);
+    const auto again = cache.get("hello there", salt, EVP_aes_256_gcm(), pbkdf2);
+    assert(cache.hits() == 1);
+    assert(memcmp(derived.data(), again.data(), 32) == 0);
+    assert(memcmp(derived.iv(), again.iv(), 12) == 0);
+    auto wide = pbkdf2;
+    wide.cost = (uint64_t(1) << 32) + 1000;
+    uint8_t material[32];
+    assert(!crypto::derive_key("hello there", salt, material, sizeof(material), wide));
+
+    crypto::kdf_params scrypt;
+    scrypt.kdf = crypto::kdf_t::scrypt;
+    scrypt.cost = 1024;
+    assert(cache.get("hello there", salt, EVP_aes_256_gcm(), scrypt));
+    assert(cache.get("other", salt, EVP_aes_256_gcm(), pbkdf2));
+    assert(cache.size() == 2);
+
+    crypto::kdf_params hkdf;
+    hkdf.kdf = crypto::kdf_t::hkdf;
+    hkdf.info = "session";
+    const crypto::keyphrase_t expanded("input key material", salt, EVP_aes_128_gcm(), hkdf);
+    assert(expanded.size() == 16);
+
+    const crypto::keyphrase_t gcm("packet key", crypto::nosalt, EVP_aes_256_gcm());
+    crypto::encrypt_t sender(gcm);
+    crypto::decrypt_t receiver(gcm);
+    crypto::nonce_t nonces(gcm.iv());
+    const uint8_t aad[4] = {1, 2, 3, 4};
+    uint8_t packet[64], sealed_packet[64], opened_packet[64], tag[16];
+    memset(packet, 0x5a, sizeof(packet));
+    for (uint64_t seq = 0; seq < 3; ++seq) {
+        const auto nonce = nonces.next();
+        assert(sender.seal(nonce, aad, sizeof(aad), packet, sizeof(packet), sealed_packet, tag));
+        assert(receiver.open(nonces.at(seq), aad, sizeof(aad), sealed_packet, sizeof(sealed_packet), opened_packet, tag));
+        assert(memcmp(packet, opened_packet, sizeof(packet)) == 0);
+    }
+    assert(nonces.sequence() == 3);
+    sealed_packet[0] ^= 1;
+    assert(!receiver.open(nonces.at(2), aad, sizeof(aad), sealed_packet, sizeof(sealed_packet), opened_packet, tag));
+
+    bytearray_t inplace(packet, sizeof(packet));
+    assert(sender.seal(nonces.at(7), aad, sizeof(aad), inplace, tag));
+    const std::vector<crypto::key_t> aad_list = {{aad, 2}, {aad + 2, 2}};
+    const std::vector<crypto::key_t> frags = {{packet, 10}, {packet + 10, 54}};
+    assert(sender.seal(nonces.at(7), aad_list, frags, sealed_packet, tag));
+    assert(memcmp(inplace.data(), sealed_packet, sizeof(packet)) == 0);
+    assert(receiver.open(nonces.at(7), aad, sizeof(aad), inplace, tag));
+    assert(memcmp(inplace.data(), packet, sizeof(packet)) == 0);
+
+    task_pool pool(4);
+    crypto::kdf_params quick;
+    quick.cost = 1000;
+    const crypto::segments_t seal("hello there", EVP_chacha20_poly1305(), 1024, quick);
+    std::vector<uint8_t> plain(5000), sealed(seal.sealed_size(plain.size())), opened(plain.size());
+    for (std::size_t pos = 0; pos < plain.size(); ++pos)
+        plain[pos] = uint8_t(pos);
+    assert(seal.segments(plain.size()) == 5);
+    assert(seal.encrypt(plain.data(), plain.size(), sealed.data(), pool) == sealed.size());
+
+    const crypto::segments_t open("hello there", sealed.data());
+    assert(open.plain_size(sealed.size()) == plain.size());
+    assert(open.decrypt(sealed.data(), sealed.size(), opened.data(), pool) == plain.size());
+    assert(opened == plain);
+    assert(seal.header()[6] == uint8_t(crypto::kdf_t::pbkdf2) && be_get32(seal.header() + 12) == 1000);
+
+    auto refused = false;
+    std::vector<uint8_t> forged(seal.header(), seal.header() + crypto::segments_t::header_size);
+    be_set32(forged.data() + 12, UINT32_MAX);
+    try {
+        const crypto::segments_t costly("hello there", forged.data());
+    } catch (const std::exception& e) {
+        refused = true;
+    }
+    assert(refused);
+
+    uint8_t part[1024];
+    assert(open.open(2, sealed.data() + open.offset(2), 1024 + crypto::segments_t::tag_size, part));
+    assert(memcmp(part, plain.data() + 2048, sizeof(part)) == 0);
+    assert(!open.open(2, sealed.data() + open.offset(2), 1024 + crypto::segments_t::tag_size, part, true));
+
+    auto truncated = false;
+    try {
+        open.decrypt(sealed.data(), open.offset(4), opened.data(), pool);
+    } catch (const std::exception& e) {
+        truncated = true;
+    }
+    assert(truncated);
+
+    std::stringstream source, target, result;
+    source.write(reinterpret_cast<const char *>(plain.data()), std::streamsize(plain.size()));
+    assert(seal.encrypt(source, target, pool));
+    assert(target.str().size() == sealed.size());
+    target.seekg(crypto::segments_t::header_size);
+    assert(open.decrypt(target, result, pool));
+    assert(result.str() == std::string(plain.begin(), plain.end()));
 }
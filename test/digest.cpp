@@ -8,6 +8,8 @@
 #include "encoding.hpp"
 #include "templates.hpp"
 
+#include <sstream>
+
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     crypto::digest_t digest(EVP_sha256());
     assert(is(digest) == true);
@@ -16,4 +18,36 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     digest.finish();
     assert(digest.size() == 32);
     assert(to_hex(digest.view()) == "b94d27b9934d3e08a52e52d7da7dabfac484efe37a5380ee9088f7ace2efcde9");
+    assert(digest.to_hex() == to_hex(digest.view()));
+    std::stringstream out;
+    out << digest;
+    assert(out.str() == digest.to_hex());
+
+    crypto::keyed_cache<int> cache(2), other(2);
+    crypto::keyed_cache<int>::id_t id{}, id2{}, same{};
+    auto hash = cache.hash();
+    hash.update("phrase");
+    assert(cache.make_id(hash, id));
+    hash = cache.hash();
+    hash.update("phrase");
+    assert(cache.make_id(hash, same) && id == same);
+    hash = other.hash();
+    hash.update("phrase");
+    assert(other.make_id(hash, id2) && id != id2);
+
+    cache.emplace(id, 1);
+    cache.emplace(id2, 2);
+    cache.emplace(id, 3);
+    assert(cache.size() == 2);
+    auto value = 0;
+    assert(cache.find(id, [&value](int entry) {
+        value = entry;
+        return true;
+    }) && value == 1);
+    cache.emplace(same = {}, 4);
+    assert(cache.size() == 2 && cache.hits() == 1);
+    assert(!cache.find(id2, [](int) { return true; }));
+    assert(!cache.find(id, [](int) { return false; }));
+    assert(cache.size() == 1);
+    assert(cache.erase_if([](int entry) { return entry == 4; }) == 1);
 }
@@ -11,4 +11,106 @@
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     const crypto::eckey_t keypair;
     assert(is(keypair));
+
+    const std::string_view msg = "hello world";
+    crypto::sign_t signer(keypair.share());
+    assert(signer.update(msg));
+    assert(signer.finish());
+
+    const crypto::pubkey_t pubkey(keypair.pub());
+    assert(is(pubkey));
+    uint8_t raw[256];
+    std::size_t size = 0;
+    assert(EVP_PKEY_get_octet_string_param(pubkey.get(), OSSL_PKEY_PARAM_PUB_KEY, raw, sizeof(raw), &size) == 1);
+    crypto::pubkey_cache cache;
+    const auto peer = cache.get(crypto::key_t(raw, size));
+    assert(is(peer));
+    assert(cache.size() == 1);
+    assert(is(cache.get(crypto::key_t(raw, size))));
+    assert(cache.hits() == 1);
+
+    crypto::pubkey_cache lru("secp521r1", 2);
+    const crypto::eckey_t key2, key3;
+    const crypto::pubkey_t pub2(key2.pub()), pub3(key3.pub());
+    uint8_t raw2[256], raw3[256];
+    std::size_t size2 = 0, size3 = 0;
+    assert(EVP_PKEY_get_octet_string_param(pub2.get(), OSSL_PKEY_PARAM_PUB_KEY, raw2, sizeof(raw2), &size2) == 1);
+    assert(EVP_PKEY_get_octet_string_param(pub3.get(), OSSL_PKEY_PARAM_PUB_KEY, raw3, sizeof(raw3), &size3) == 1);
+    assert(is(lru.get(crypto::key_t(raw, size))));
+    assert(is(lru.get(crypto::key_t(raw2, size2))));
+    assert(is(lru.get(crypto::key_t(raw, size))));
+    assert(is(lru.get(crypto::key_t(raw3, size3))));
+    assert(lru.size() == 2);
+    assert(is(lru.get(crypto::key_t(raw, size))));
+    assert(lru.hits() == 2);
+
+    const auto message = crypto::key_t(reinterpret_cast<const uint8_t *>(msg.data()), msg.size());
+    const auto signature = crypto::key_t(signer.data(), signer.size());
+    const auto wrong = crypto::key_t(reinterpret_cast<const uint8_t *>("other"), 5);
+    std::vector<crypto::verify_item> items(8, {peer.get(), message, signature});
+    items[5].message = wrong;
+
+    task_pool pool(4);
+    auto results = crypto::verify_batch(items, pool);
+    assert(results.size() == 8);
+    assert(results[0] == crypto::verified::valid);
+    assert(results[5] == crypto::verified::invalid);
+    assert(results[7] == crypto::verified::valid);
+
+    task_pool single(1);
+    results = crypto::verify_batch(items, single, true);
+    assert(results[4] == crypto::verified::valid);
+    assert(results[5] == crypto::verified::invalid);
+    assert(results[6] == crypto::verified::skipped);
+
+    const crypto::ed25519_t edkey;
+    assert(edkey.pub_raw().second == 32);
+    crypto::sign_t edsign(edkey.share());
+    assert(edsign.update(msg));
+    assert(edsign.finish());
+    assert(edsign.size() == 64);
+    const crypto::pubkey_t edpub(edkey.pub_raw(), "ED25519");
+    crypto::verify_t edverify(edpub.share());
+    assert(edverify.update(msg));
+    assert(edverify.finish(edsign.data(), edsign.size()));
+    assert(crypto::verify(edpub.get(), message, crypto::key_t(edsign.data(), edsign.size())));
+
+    crypto::x25519_t alice, bob;
+    const crypto::pubkey_t alice_pub(alice.pub_raw(), "X25519"), bob_pub(bob.pub_raw(), "X25519");
+    const auto shared1 = alice.derive(bob_pub.get(), "session", 32);
+    const auto shared2 = bob.derive(alice_pub.get(), "session", 32);
+    assert(shared1.second == 32 && shared2.second == 32);
+    assert(memcmp(shared1.first, shared2.first, 32) == 0);
+
+    crypto::session_cache sessions(4);
+    crypto::eckey_t local;
+    const crypto::eckey_t remote;
+    const crypto::pubkey_t remote_pub(remote.pub());
+    const auto first = local.derive(sessions, remote_pub.get(), "session");
+    assert(first.second == 32);
+    uint8_t saved[32];
+    memcpy(saved, first.first, sizeof(saved));
+    const auto second = local.derive(sessions, remote_pub.get(), "session");
+    assert(sessions.hits() == 1);
+    assert(memcmp(saved, second.first, sizeof(saved)) == 0);
+    assert(local.derive(sessions, remote_pub.get(), "other").second == 32);
+    assert(sessions.size() == 2);
+    assert(alice.derive(sessions, bob_pub.get(), "session", 32).second == 32);
+    assert(sessions.size() == 3);
+    assert(sessions.expire() == 0);
+
+    // least recently used entries go first, and expired ones are dropped
+    for (const auto *info : {"a", "b", "c"})
+        assert(local.derive(sessions, remote_pub.get(), info).second == 32);
+    assert(sessions.size() == 4);
+    assert(local.derive(sessions, remote_pub.get(), "session").second == 32);
+    assert(sessions.hits() == 1 && sessions.size() == 4);
+    sessions.clear();
+    assert(sessions.size() == 0);
+
+    crypto::session_cache brief(4, std::chrono::seconds(0));
+    assert(local.derive(brief, remote_pub.get(), "session").second == 32);
+    assert(local.derive(brief, remote_pub.get(), "session").second == 32);
+    assert(brief.hits() == 0 && brief.size() == 1);
+    assert(brief.expire() == 1 && brief.size() == 0);
 }
@@ -0,0 +1,192 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#undef NDEBUG
+#include "compiler.hpp" // IWYU pragma: keep
+#include "print.hpp"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <unistd.h>
+#include <fcntl.h>
+
+using namespace tycho;
+
+namespace {
+auto lines_in(const std::string& text) {
+    std::size_t count = 0;
+    for (auto ch : text) {
+        if (ch == '\n') ++count;
+    }
+    return count;
+}
+
+auto read_all(int fd) {
+    std::string text;
+    char buf[4096];
+    for (;;) {
+        auto len = ::read(fd, buf, sizeof(buf));
+        if (len <= 0) break;
+        text.append(buf, std::size_t(len));
+    }
+    return text;
+}
+} // namespace
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    int pipes[2];
+    assert(::pipe(pipes) == 0);
+
+    // a blocking ring loses nothing from many producers
+    std::atomic<unsigned> notified{0};
+    std::string output;
+    std::thread reader([&] { output = read_all(pipes[0]); });
+    {
+        system_logger logger;
+        logger.set(2, [&](const std::string& msg, const char *type) {
+            if (std::string_view(type) == "warning") assert(msg.find("warn ") == 0);
+            ++notified;
+        });
+        logger.async(4096, log_policy::block, pipes[1]);
+        std::vector<std::thread> threads;
+        for (unsigned id = 0; id < 4; ++id) {
+            threads.emplace_back([&logger, id] {
+                for (unsigned count = 0; count < 2000; ++count) {
+                    if (count % 2)
+                        logger.info("thread {} line {}", id, count);
+                    else
+                        logger.warn("warn {} {}", id, std::string(count % 300, 'x'));
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        logger.flush();
+        assert(notified == 8000);
+        assert(logger.dropped() == 0);
+    }
+    ::close(pipes[1]);
+    reader.join();
+    assert(lines_in(output) == 8000);
+    assert(output.find("info: thread 3 line 1999\n") != std::string::npos);
+
+    // replacing notify while threads log does not race the writer
+    assert(::pipe(pipes) == 0);
+    std::thread discard([&] { read_all(pipes[0]); });
+    {
+        std::atomic<unsigned> first{0}, second{0};
+        system_logger logger;
+        logger.set(1, [&](const std::string&, const char *) { ++first; });
+        logger.async(1 << 16, log_policy::block, pipes[1]);
+        std::thread worker([&logger] {
+            for (unsigned count = 0; count < 2000; ++count)
+                logger.warn("swap {}", count);
+        });
+        for (unsigned count = 0; count < 20; ++count)
+            logger.set(1, [&first, &second, count](const std::string&, const char *) { ++(count % 2 ? first : second); });
+        worker.join();
+        logger.flush();
+        assert(first + second == 2000);
+    }
+    ::close(pipes[1]);
+    discard.join();
+    ::close(pipes[0]);
+
+    // a dropping ring counts what a stalled sink could not take
+    assert(::pipe(pipes) == 0);
+    {
+        system_logger logger;
+        logger.set(1);
+        logger.async(4096, log_policy::drop, pipes[1]);
+        const std::string filler(200, 'y');
+        for (unsigned count = 0; count < 1000; ++count)
+            logger.error("{} {}", count, filler);
+        std::thread drain([&] { output = read_all(pipes[0]); });
+        logger.flush();
+        auto dropped = logger.dropped();
+        assert(dropped > 0);
+        logger.sync();
+        ::close(pipes[1]);
+        drain.join();
+        assert(lines_in(output) + dropped == 1000);
+    }
+    ::close(pipes[0]);
+
+    // console records a non-blocking sink refuses are counted as dropped
+    assert(::pipe(pipes) == 0);
+    assert(::fcntl(pipes[1], F_SETFL, ::fcntl(pipes[1], F_GETFL) | O_NONBLOCK) == 0);
+    {
+        system_logger logger;
+        logger.set(1);
+        logger.async(1 << 20, log_policy::drop, pipes[1]);
+        const std::string filler(200, 'z');
+        for (unsigned count = 0; count < 2000; ++count)
+            logger.error("{} {}", count, filler);
+        logger.flush();
+        const auto dropped = logger.dropped();
+        assert(dropped > 0);
+        logger.sync();
+        ::close(pipes[1]);
+        output = read_all(pipes[0]);
+        assert(lines_in(output) + dropped == 2000);
+    }
+    ::close(pipes[0]);
+
+    // binary records copy text arguments and format on the writer
+    assert(::pipe(pipes) == 0);
+    std::thread collect([&] { output = read_all(pipes[0]); });
+    {
+        system_logger logger;
+        logger.set(1);
+        logger.async(1 << 16, log_policy::drop, pipes[1]);
+        for (int count = 0; count < 3; ++count) {
+            const std::string peer = "host-" + std::to_string(count);
+            TYCHO_RECORD(logger, log_async::warn, "{} from {} took {:.2f}ms on '{}'", count, peer, 1.5 * count, "link");
+        }
+        TYCHO_RECORD(logger, log_async::info, "hidden {}", 1);
+        TYCHO_RECORD(logger, log_async::error, "size {} {}", sizeof(int), std::string_view("view"));
+        TYCHO_RECORD(logger, log_async::notice, "no arguments");
+
+        // one registered id per call site, across threads
+        std::vector<std::thread> threads;
+        for (unsigned id = 0; id < 4; ++id) {
+            threads.emplace_back([&logger, id] {
+                for (unsigned count = 0; count < 100; ++count)
+                    TYCHO_RECORD(logger, log_async::notice, "request {} status {} bytes {}", (id * 100) + count, 200, 1024.5);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        assert(logger.dropped() == 0);
+        logger.sync();
+        ::close(pipes[1]);
+    }
+    collect.join();
+    assert(output.find("warn: 0 from host-0 took 0.00ms on 'link'\n") == 0);
+    assert(output.find("warn: 2 from host-2 took 3.00ms on 'link'\n") != std::string::npos);
+    assert(output.find("hidden") == std::string::npos);
+    assert(output.find("error: size 4 view\n") != std::string::npos);
+    assert(output.find("notice: no arguments\n") != std::string::npos);
+    assert(output.find("notice: request 399 status 200 bytes 1024.5\n") != std::string::npos);
+    assert(lines_in(output) == 405);
+
+    // without a writer records format on the caller
+    {
+        std::string seen;
+        system_logger logger;
+        logger.set(0, [&seen](const std::string& msg, const char *type) { seen = std::string(type) + " " + msg; });
+        TYCHO_RECORD(logger, log_async::error, "{}-{}", "sync", 2);
+        assert(seen == "error sync-2");
+    }
+
+    // only deferred kinds can describe a record site
+    auto refused = false;
+    try {
+        const log_format site(log_async::crit, "crit {}");
+    } catch (const std::invalid_argument& e) {
+        refused = true;
+    }
+    assert(refused);
+}
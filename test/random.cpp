@@ -7,6 +7,13 @@
 #include "strings.hpp"
 #include "encoding.hpp"
 
+#include <openssl/evp.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     const crypto::random_t<crypto::sha512_key> key1, key2;
     assert(key1.bits() == 512);
@@ -26,4 +33,82 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     assert(from_b64("QUJDRFoxMg==", msg, sizeof(msg)) == 7);
     // cspell:disable-next-line
     assert(eq("ABCDZ12", reinterpret_cast<const char *>(msg)));
+
+    uint8_t small[16]{0}, large[4096]{0};
+    crypto::rand(small, sizeof(small));
+    crypto::rand(large, sizeof(large));
+    assert(memcmp(small, large, sizeof(small)) != 0);
+
+#ifndef _WIN32
+    // a forked child must not replay bytes still buffered in the parent
+    int fds[2];
+    assert(pipe(fds) == 0);
+    const auto child = fork();
+    assert(child >= 0);
+    crypto::rand(small, sizeof(small));
+    if (!child) {
+        auto result = write(fds[1], small, sizeof(small));
+        _exit(result == sizeof(small) ? 0 : 1);
+    }
+    uint8_t forked[16]{0};
+    assert(read(fds[0], forked, sizeof(forked)) == sizeof(forked));
+    int status = 0;
+    assert(waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(memcmp(small, forked, sizeof(small)) != 0);
+    close(fds[0]);
+    close(fds[1]);
+#endif
+
+    crypto::xoshiro_t gen1(42), gen2(42), gen3(42);
+    assert(gen1() == gen2());
+    gen3.jump();
+    assert(gen1() != gen3());
+    for (int count = 0; count < 1000; ++count) {
+        assert(crypto::bounded(gen1, 7) < 7);
+        assert(crypto::secure_range(10) < 10);
+        auto value = crypto::random_dist(-3, 3);
+        assert(value >= -3 && value <= 3);
+    }
+    assert(crypto::bounded(gen1, 0) == 0);
+    assert(crypto::random_dist(5, 5) == 5);
+    assert(crypto::random_dist(INT32_MIN, INT32_MAX) >= INT32_MIN);
+
+    uint8_t bulk[13]{0};
+    crypto::fill(gen2, bulk, sizeof(bulk));
+    crypto::fast_fill(bulk, sizeof(bulk));
+    std::uniform_int_distribution<int> dist(1, 6);
+    auto roll = dist(crypto::fast_random());
+    assert(roll >= 1 && roll <= 6);
+
+    uint8_t plain[300], back[300];
+    char text[404];
+    crypto::fast_fill(plain, sizeof(plain));
+    for (std::size_t size = 0; size <= sizeof(plain); ++size) {
+        auto len = EVP_EncodeBlock(reinterpret_cast<uint8_t *>(text), plain, int(size));
+        assert(to_b64(plain, size) == std::string_view(text, std::size_t(len)));
+        assert(b64_decode(std::string_view(text, std::size_t(len)), back, sizeof(back)) == size);
+        assert(memcmp(plain, back, size) == 0);
+
+        auto url = to_b64(plain, size, b64_t::url_nopad);
+        assert(url.size() == b64_encoded_size(size, b64_t::url_nopad));
+        assert(url.find_first_of("+/=") == std::string::npos);
+        assert(b64_decode(url, back, sizeof(back), b64_t::url_nopad) == size);
+        assert(memcmp(plain, back, size) == 0);
+    }
+
+    // strict validation
+    assert(b64_decode("QUJDRFoxMg", msg, sizeof(msg)) == 0);
+    assert(b64_decode("QUJDRFoxMg", msg, sizeof(msg), b64_t::nopad) == 7);
+    assert(b64_decode("QUJDRFoxMh==", msg, sizeof(msg)) == 0);
+    assert(b64_decode("QU=DRFoxMg==", msg, sizeof(msg)) == 0);
+    assert(b64_decode("QUJD RFoxMg=", msg, sizeof(msg)) == 0);
+    assert(b64_decode("QUJDRFoxMg==", msg, 6) == 0);
+    std::string bad = to_b64(plain, 96);
+    bad[40] = '*';
+    assert(b64_decode(bad, back, sizeof(back)) == 0);
+    bad = to_b64(plain, 96, b64_t::url);
+    bad[40] = '+';
+    assert(b64_decode(bad, back, sizeof(back), b64_t::url) == 0);
+    bad[40] = 'A';
+    assert(b64_decode(bad, back, sizeof(back), b64_t::url) == 96);
 }
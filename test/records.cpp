@@ -0,0 +1,74 @@
+// Copyright (C) 2025 Tycho Softworks.
+// This code is licensed under MIT license.
+
+#undef NDEBUG
+#include "compiler.hpp" // IWYU pragma: keep
+#include "records.hpp"
+
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <cstdlib>
+
+using namespace tycho;
+
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
+    record_parser simple({field_t::integer, field_t::real, field_t::text, field_t::duration}, ',', 2);
+    simple.header();
+    std::vector<std::string> names;
+    int64_t total{0};
+    unsigned seconds{0};
+    std::size_t errors{0};
+    auto rows = simple.parse("id,value,name,time\r\n-7,2.5,\"a, \"\"b\"\"\",5m\r\n\n9,1e3,plain,1:00\n12,x,\"two\nlines\"\n3", [&](const record_batch& batch) {
+        assert(batch.rows() <= 2 && batch.columns() == 4);
+        for (std::size_t row = 0; row < batch.rows(); ++row) {
+            total += batch.integers(0)[row];
+            names.emplace_back(batch.texts(2)[row]);
+            seconds += batch.durations(3)[row];
+        }
+        errors += batch.errors();
+    });
+    assert(rows == 4);
+    assert(total == 17 && seconds == 360);
+    assert(names.size() == 4 && names[0] == "a, \"b\"" && names[1] == "plain" && names[2] == "two\nlines" && names[3].empty());
+    assert(errors == 1);
+
+    // long generated input split over a pool must match a serial parse
+    std::string text;
+    int64_t expected{0};
+    for (int row = 0; row < 5000; ++row) {
+        expected += row * 3 - 7;
+        text += std::to_string(row * 3 - 7) + "\t";
+        text += (row % 7) ? "word" : "\"quoted\ttab\nand line\"";
+        text += "\t" + std::to_string(row) + ".25\n";
+    }
+
+    record_parser tabs({field_t::integer, field_t::text, field_t::real}, '\t', 256);
+    tabs.chunk_size(97);
+    task_pool pool(4);
+    std::mutex lock;
+    int64_t sum{0};
+    double reals{0.0};
+    std::size_t quoted{0};
+    auto collect = [&](const record_batch& batch) {
+        const std::lock_guard guard(lock);
+        for (std::size_t row = 0; row < batch.rows(); ++row) {
+            assert(batch.valid(0)[row] && batch.valid(2)[row]);
+            sum += batch.integers(0)[row];
+            reals += batch.reals(2)[row];
+            if (batch.texts(1)[row] == "quoted\ttab\nand line") ++quoted;
+        }
+    };
+    assert(tabs.parse(pool, text, collect) == 5000);
+    assert(sum == expected && quoted == 715);
+    assert(reals == 5000 * 4999 / 2 + 5000 * 0.25);
+
+    sum = 0;
+    quoted = 0;
+    reals = 0.0;
+    const std::string path = "records-test.tsv";
+    std::ofstream(path) << text;
+    assert(tabs.parse_file(pool, path, collect) == 5000);
+    assert(sum == expected && quoted == 715);
+    std::remove(path.c_str());
+}
@@ -5,6 +5,8 @@
 #include "compiler.hpp" // IWYU pragma: keep
 #include "scan.hpp"
 #include <cstdlib>
+#include <cmath>
+#include <string>
 
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     try {
@@ -50,6 +52,35 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
         assert(get_hex<uint16_t>("$fff0") == 65520);
         assert(get_unsigned<uint16_t>("0xfff0") == 65520);
         assert(get_hex<uint16_t>("0xffff") == 65535);
+        assert(get_hex<uint64_t>("0xDEADbeef01234567") == 0xdeadbeef01234567ULL);
+        assert(get_hex_or<uint8_t>("1g", 7) == 7);
+        assert(get_unsigned<uint64_t>("18446744073709551615") == UINT64_MAX);
+        assert(get_unsigned_or<uint64_t>("18446744073709551616", 3) == 3);
+        assert(get_unsigned<uint32_t>("000000001234567890") == 1234567890U);
+        assert(get_unsigned_or<uint16_t>("65536", 9) == 9);
+        assert(get_unsigned_or<uint32_t>("1234567a9", 9) == 9);
+        std::string digits;
+        for (unsigned len = 1; len <= 19; ++len) {
+            digits += char('0' + (len * 7) % 10);
+            assert(get_unsigned<uint64_t>(digits) == std::strtoull(digits.c_str(), nullptr, 10));
+        }
+
+        // results must round exactly as strtod does
+        for (const auto *str : {"0.1", "17.05", "3.14159265358979323846264338327950288", "1e23", "8.98846567431158e307", "2.2250738585072014e-308", "4.9e-324", "123456789012345678901234567890", "0.000000000000000000000000123", "9007199254740993", "1.7976931348623157e308", "7.2057594037927933e16", "0e500", "1E-5", "2.5e+3", "00012.50", "1234567890.12345678901", "12345678.87654321e-30"}) {
+            const std::string_view text{str};
+            const double exact = std::strtod(str, nullptr);
+            if (text.find_first_of("eE") == std::string_view::npos) {
+                assert(get_decimal(text) == exact);
+                assert(get_decimal(std::string("-") + str) == -exact);
+            }
+            assert(get_real(text) == exact);
+        }
+        assert(std::isinf(get_real("1e400")) && get_real("1e-400") == 0.0);
+        assert(get_real_or("1.5e3x", -1.0) == -1.0);
+        assert(get_decimal_or("1.5x", -1.0) == -1.0);
+        assert(get_decimal(".5") == 0.5 && get_decimal("12.") == 12.0);
+        std::string_view bounded{"300.5"};
+        assert(scan::decimal(bounded, 255) == 30.0 && bounded == "0.5");
     } catch (std::exception& e) {
         printf("Error: %s\n", e.what());
         ::exit(-1);
@@ -3,13 +3,237 @@
 
 #undef NDEBUG
 #include "compiler.hpp" // IWYU pragma: keep
-#include "print.hpp"    // IWYU pragma: keep
 #include "serial.hpp"
 
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#if __has_include(<termios.h>)
+#include <cstdlib>
+#endif
+
+namespace {
+auto crc32_bitwise(uint32_t poly, const uint8_t *data, std::size_t size) {
+    uint32_t crc = 0xffffffff;
+    while (size--) {
+        crc ^= *(data++);
+        for (auto bit = 0; bit < 8; ++bit)
+            crc = (crc & 1) ? poly ^ (crc >> 1) : crc >> 1;
+    }
+    return crc ^ 0xffffffff;
+}
+
+template <typename Decoder>
+auto split_feed(Decoder& decoder, const std::vector<uint8_t>& wire, std::size_t step, std::vector<std::string>& frames) {
+    std::size_t count = 0;
+    for (std::size_t pos = 0; pos < wire.size(); pos += step) {
+        count += decoder.feed(wire.data() + pos, std::min(step, wire.size() - pos), [&frames](const uint8_t *data, std::size_t size) {
+            frames.emplace_back(reinterpret_cast<const char *>(data), size);
+        });
+    }
+    return count;
+}
+
+} // end namespace
+
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
 // This is so we can lint serial on non-termios systems without errors...
 #ifdef SERIAL_HPP_
     const serial_t serial;
     assert(is(serial) == false);
 #endif
+
+    const auto check = reinterpret_cast<const uint8_t *>("123456789");
+    assert(crc32(check, 9) == 0xcbf43926);
+    assert(crc32c(check, 9) == 0xe3069283);
+    assert(crc16(check, 9) == 0xfee8);
+
+    uint8_t data[1031];
+    for (std::size_t pos = 0; pos < sizeof(data); ++pos)
+        data[pos] = uint8_t((pos * 2654435761U) >> 13);
+    for (std::size_t size = 0; size < 300; ++size) {
+        assert(crc32(data + 3, size) == crc32_bitwise(0xedb88320, data + 3, size));
+        assert(crc32c(data + 1, size) == crc32_bitwise(0x82f63b78, data + 1, size));
+    }
+    assert(crc32(data, sizeof(data)) == crc32_bitwise(0xedb88320, data, sizeof(data)));
+
+    crc32_engine engine;
+    crc32c_engine engine_c;
+    crc16_engine engine16;
+    for (std::size_t pos = 0; pos < sizeof(data); pos += 97) {
+        auto size = std::min<std::size_t>(97, sizeof(data) - pos);
+        engine.update(data + pos, size);
+        engine_c.update(data + pos, size);
+        engine16.update(data + pos, size);
+    }
+    assert(engine.final() == crc32(data, sizeof(data)));
+    assert(engine_c.final() == crc32c(data, sizeof(data)));
+    assert(engine16.final() == crc16(data, sizeof(data)));
+    engine.init();
+    assert(engine.update("123456789").final() == 0xcbf43926);
+
+#if __has_include(<termios.h>)
+    auto master = posix_openpt(O_RDWR | O_NOCTTY);
+    assert(master > -1);
+    assert(grantpt(master) == 0 && unlockpt(master) == 0);
+    serial_t port(ptsname(master));
+    assert(static_cast<bool>(port));
+    assert(port.is_blocking());
+
+    serial_reactor reactor(64);
+    std::string received;
+    assert(reactor.attach(port, [&received](serial_t&, serial_ring& ring) {
+        uint8_t buf[32];
+        while (!ring.empty()) {
+            auto count = ring.read(buf, sizeof(buf));
+            received.append(reinterpret_cast<const char *>(buf), count);
+        }
+    }));
+    assert(!port.is_blocking());
+    assert(!reactor.attach(port, [](serial_t&, serial_ring&) {}));
+    char none[4];
+    assert(port.get(none, sizeof(none)) == 0);
+
+    const std::string msg(200, 'x');
+    assert(::write(master, msg.data(), msg.size()) == ssize_t(msg.size()));
+    while (received.size() < msg.size())
+        assert(reactor.poll(1000) > 0);
+    assert(received == msg);
+
+    std::size_t written = 0;
+    assert(reactor.write(port, "hello", [&written](std::size_t size, int err) {
+        assert(err == 0);
+        written = size;
+    }));
+    while (!written)
+        reactor.poll(1000);
+    assert(written == 5 && reactor.pending(port) == 0);
+    char reply[8]{0};
+    assert(::read(master, reply, sizeof(reply)) == 5);
+    assert(std::string_view(reply, 5) == "hello");
+
+    serial_ring ring(8);
+    const uint8_t seq[6] = {1, 2, 3, 4, 5, 6};
+    assert(ring.write(seq, 6) == 6);
+    ring.consume(4);
+    assert(ring.write(seq, 6) == 6 && ring.full());
+    uint8_t out[8];
+    assert(ring.front().second == 4);
+    assert(ring.read(out, 8) == 8 && out[1] == 6 && out[2] == 1 && out[7] == 6);
+
+    assert(reactor.detach(port) && reactor.size() == 0);
+    assert(port.is_blocking());
+
+    // a receiver that keeps the ring full pauses input until it drains
+    serial_ring *held{nullptr};
+    assert(reactor.attach(port, [&held](serial_t&, serial_ring& input) {
+        held = &input;
+    }));
+    assert(::write(master, msg.data(), msg.size()) == ssize_t(msg.size()));
+    assert(reactor.poll(1000) == 1 && held && held->full());
+    assert(reactor.poll(0) == 0);
+    held->clear();
+    assert(reactor.poll(1000) == 1 && held->full());
+    do
+        held->clear();
+    while (reactor.poll(100));
+    assert(reactor.detach(port) && port.is_blocking());
+
+    // echo one frame by hand in each read mode
+    char echo[64];
+    const std::string chunk(16, 'a');
+    port.timed_mode(chunk.size(), 10);
+    assert(port.put(chunk) == chunk.size());
+    assert(::read(master, echo, sizeof(echo)) == ssize_t(chunk.size()));
+    assert(::write(master, echo, chunk.size()) == ssize_t(chunk.size()));
+    std::string back(chunk.size(), 0);
+    assert(port.get(back.data(), back.size()) == chunk.size() && back == chunk);
+
+    port.line_mode("\n");
+    assert(::write(master, "line\n", 5) == 5);
+    back.assign(16, 0);
+    assert(port.get(back.data(), back.size()) == 5 && back.substr(0, 5) == "line\n");
+
+    port.close();
+    ::close(master);
+#endif
+
+    std::vector<std::string> samples = {"hello", std::string("\xc0\xdb\x00\x01", 4), std::string(300, '\0'), std::string(600, 'z'), "x"};
+    for (auto crc : {frame_crc::none, frame_crc::crc16, frame_crc::crc32c}) {
+        std::vector<uint8_t> slip_wire, cobs_wire, length_wire, line_wire, frame;
+        for (const auto& sample : samples) {
+            auto ptr = reinterpret_cast<const uint8_t *>(sample.data());
+            slip_encode(ptr, sample.size(), frame, crc);
+            slip_wire.insert(slip_wire.end(), frame.begin(), frame.end());
+            cobs_encode(ptr, sample.size(), frame, crc);
+            assert(std::count(frame.begin(), frame.end(), 0) == 1);
+            cobs_wire.insert(cobs_wire.end(), frame.begin(), frame.end());
+            length_encode(ptr, sample.size(), frame, 2, crc);
+            length_wire.insert(length_wire.end(), frame.begin(), frame.end());
+            assert(delimiter_encode(ptr, sample.size(), frame, "\r\n", crc) == sample.size() + (crc_size(crc) * 2) + 2);
+            line_wire.insert(line_wire.end(), frame.begin(), frame.end());
+        }
+        for (auto step : {std::size_t(1), std::size_t(3), std::size_t(64), std::size_t(4096)}) {
+            std::vector<std::string> frames;
+            slip_decoder slip(1024, crc);
+            assert(split_feed(slip, slip_wire, step, frames) == samples.size());
+            assert(frames == samples && slip.errors() == 0);
+
+            frames.clear();
+            cobs_decoder cobs(1024, crc);
+            assert(split_feed(cobs, cobs_wire, step, frames) == samples.size());
+            assert(frames == samples && cobs.errors() == 0);
+
+            frames.clear();
+            length_decoder length(1024, 2, crc);
+            assert(split_feed(length, length_wire, step, frames) == samples.size());
+            assert(frames == samples && length.errors() == 0);
+
+            frames.clear();
+            delimiter_decoder lines("\r\n", 1024, crc);
+            assert(split_feed(lines, line_wire, step, frames) == samples.size());
+            assert(frames == samples && lines.errors() == 0);
+        }
+    }
+
+    // damaged and oversize frames are dropped and counted
+    std::vector<uint8_t> frame, wire;
+    slip_encode(reinterpret_cast<const uint8_t *>("data"), 4, frame, frame_crc::crc32);
+    frame[2] ^= 1;
+    wire = frame;
+    slip_encode(reinterpret_cast<const uint8_t *>("next"), 4, frame, frame_crc::crc32);
+    wire.insert(wire.end(), frame.begin(), frame.end());
+    std::vector<std::string> found;
+    slip_decoder checked(16, frame_crc::crc32);
+    assert(split_feed(checked, wire, 5, found) == 1 && found[0] == "next" && checked.errors() == 1);
+
+    found.clear();
+    length_decoder small(4);
+    length_encode(reinterpret_cast<const uint8_t *>("toolong"), 7, frame);
+    wire = frame;
+    length_encode(reinterpret_cast<const uint8_t *>("ok"), 2, frame);
+    wire.insert(wire.end(), frame.begin(), frame.end());
+    assert(split_feed(small, wire, 3, found) == 1 && found[0] == "ok" && small.errors() == 1);
+
+    found.clear();
+    delimiter_decoder line("\n", 4);
+    const std::string text = "abcdefgh\nok\n";
+    std::vector<uint8_t> lines(text.begin(), text.end());
+    assert(split_feed(line, lines, 2, found) == 1 && found[0] == "ok" && line.errors() == 1);
+
+    // a payload holding the delimiter cannot be framed, a checksum never can
+    assert(delimiter_encode(reinterpret_cast<const uint8_t *>("a\nb"), 3, frame) == 0 && frame.empty());
+    assert(delimiter_encode(reinterpret_cast<const uint8_t *>("ab\r"), 3, frame, "\r\r") == 0);
+    assert(delimiter_encode(reinterpret_cast<const uint8_t *>("ab\r"), 3, frame, "\r\n") == 5);
+    wire.clear();
+    for (std::size_t count = 0; count < 1000; ++count) {
+        const auto ptr = data + (count % 512);
+        const auto size = std::size_t(std::count(ptr, ptr + 16, '\n') ? 0 : 16);
+        assert(delimiter_encode(ptr, size, frame, "\n", frame_crc::crc32) == size + 9);
+        wire.insert(wire.end(), frame.begin(), frame.end());
+    }
+    found.clear();
+    delimiter_decoder checked_lines("\n", 64, frame_crc::crc32);
+    assert(split_feed(checked_lines, wire, 7, found) == 1000 && checked_lines.errors() == 0);
 }
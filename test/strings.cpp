@@ -8,6 +8,9 @@
 #include "encoding.hpp"
 #include "memory.hpp"
 
+#include <sstream>
+#include <iterator>
+
 auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     const std::string text = "hi,bye,gone";
     const uint8_t buf[2] = {0x03, 0xff};
@@ -21,6 +24,37 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
     assert(list[1] == "bye");
     assert(list[2] == "gone");
 
+    {
+        for (auto max : {0U, 1U, 2U, 3U, 5U}) {
+            for (const std::string str : {"", ",", "a,,b", "hi,bye,gone", ",x,"}) {
+                auto eager = split(str, ",", max);
+                std::size_t pos = 0;
+                for (auto field : split_view(str, ",", max))
+                    assert(pos < eager.size() && field == eager[pos++]);
+                assert(pos == eager.size());
+            }
+        }
+
+        for (const std::string str : {"one two  three", "say \"hi there\" now", "x {a b} 'c d'", "a 'open b"}) {
+            auto eager = tokenize(str);
+            std::size_t pos = 0;
+            for (auto token : tokenize_view(str))
+                assert(pos < eager.size() && token == eager[pos++]);
+            assert(pos == eager.size());
+        }
+        auto tokens = tokenize_view("  lead  trail  ");
+        assert(std::distance(tokens.begin(), tokens.end()) == 2);
+        assert(*tokens.begin() == "lead");
+        assert(tokenize_view(" \t ", " \t").begin() == tokenize_view("").end());
+
+        std::string_view fields[3];
+        assert(split_into("a:b:c:d", fields, ":") == 3);
+        assert(fields[0] == "a" && fields[1] == "b" && fields[2] == "c:d");
+        assert(split_into("a", fields, ":") == 1 && fields[0] == "a");
+        assert(tokenize_into("set key 'some value' extra", fields) == 3);
+        assert(fields[1] == "key" && fields[2] == "'some value'");
+    }
+
     assert(upper_case("Hi There") == "HI THERE");
     assert(lower_case(std::string("Hi There")) == "hi there");
     static_assert(strip("   testing ") == "testing");
@@ -65,4 +99,138 @@ auto main([[maybe_unused]] int argc, [[maybe_unused]] char **argv) -> int {
 
     static_assert(u8verify("\xc3\xb1"));
     static_assert(!u8verify("\xa0\xa1"));
+
+    {
+        std::string mixed;
+        for (unsigned pos = 0; pos < 300; ++pos)
+            mixed += char(pos * 7 + 3);
+        auto upper = upper_case(mixed);
+        auto lower = lower_case(mixed);
+        for (std::size_t pos = 0; pos < mixed.size(); ++pos) {
+            auto ch = uint8_t(mixed[pos]);
+            assert(uint8_t(upper[pos]) == ((ch >= 'a' && ch <= 'z') ? ch - 32 : ch));
+            assert(uint8_t(lower[pos]) == ((ch >= 'A' && ch <= 'Z') ? ch + 32 : ch));
+        }
+        assert(eq_case(upper, lower) && eq_case(mixed, upper));
+        assert(!eq_case(upper, mixed.substr(1)));
+        for (auto pos : {std::size_t(0), std::size_t(15), std::size_t(33), std::size_t(299)}) {
+            auto other = lower;
+            other[pos] = '\x01';
+            assert(!eq_case(upper, other));
+        }
+
+        const std::string text = "The quick brown fox jumps over the lazy dog, THE QUICK BROWN FOX AGAIN";
+        assert(find_case(text, "QUICK") == 4);
+        assert(find_case(text, "quick", 5) == 49);
+        assert(find_case(text, "fox again") == 61);
+        assert(find_case(text, "n") == 14);
+        assert(find_case(text, "cat") == std::string_view::npos);
+        assert(find_case(text, "") == 0);
+        assert(find_case("ab", "abc") == std::string_view::npos);
+        assert(contains_case(text, "LAZY DOG"));
+        assert(begins_case("hi", "HI"));
+    }
+
+    {
+        assert(u8valid("") && u8valid("plain ascii text"));
+        assert(u8valid("\xc3\xb1") && u8valid("\xe2\x82\xac") && u8valid("\xf0\x9f\x98\x80"));
+        assert(!u8valid("\xc0\xaf") && !u8valid("\xe0\x80\xaf") && !u8valid("\xed\xa0\x80"));
+        assert(!u8valid("\xf4\x90\x80\x80") && !u8valid("\xf5\x80\x80\x80") && !u8valid("\xa0\xa1"));
+
+        // every offset and truncation so simd blocks split each sequence
+        const std::string_view chars[] = {"a", "\xc3\xb1", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xed\x9f\xbf", "\xf4\x8f\xbf\xbf"};
+        for (std::size_t lead = 0; lead < 70; ++lead) {
+            for (const auto& ch : chars) {
+                std::string text(lead, 'x');
+                text += ch;
+                text += std::string(lead % 37, 'y');
+                assert(u8valid(text));
+                if (ch.size() > 1) {
+                    auto cut = text;
+                    cut.erase(lead + ch.size() - 1, 1);
+                    assert(!u8valid(cut));
+                    assert(!u8valid(text.substr(0, lead + 1)));
+                }
+            }
+        }
+        uint32_t seed = 1;
+        for (unsigned round = 0; round < 20000; ++round) {
+            std::string text;
+            auto size = round % 90;
+            for (unsigned pos = 0; pos < size; ++pos) {
+                seed = seed * 1103515245U + 12345U;
+                auto pick = (seed >> 16) % 8;
+                text += pick < 6 ? std::string(chars[pick]) : std::string(1, char(seed >> 24));
+            }
+            auto raw = reinterpret_cast<const uint8_t *>(text.data());
+            assert(u8valid(text) == tycho::detail::u8valid_scalar(raw, text.size()));
+        }
+    }
+
+    uint8_t data[200], back[200];
+    for (std::size_t pos = 0; pos < sizeof(data); ++pos)
+        data[pos] = uint8_t(pos * 37 + 11);
+    for (std::size_t size = 0; size <= sizeof(data); ++size) {
+        auto text = to_hex(data, size);
+        assert(text.size() == size * 2);
+        for (std::size_t pos = 0; pos < size; ++pos) {
+            assert(text[pos * 2] == "0123456789abcdef"[data[pos] >> 4]);
+            assert(text[pos * 2 + 1] == "0123456789abcdef"[data[pos] & 0x0f]);
+        }
+        assert(hex_decode(to_hex(data, size, true), back, sizeof(back)) == size);
+        assert(memcmp(data, back, size) == 0);
+    }
+    auto upper = to_hex(data, 64, true);
+    upper[70] = 'g';
+    assert(hex_decode(upper, back, sizeof(back)) == 35);
+    assert(hex_decode(upper, back, 20) == 20);
+    char out[8];
+    assert(hex_encode(buf, sizeof(buf), tycho::span<char>(out, 3)) == 0);
+    assert(hex_encode(buf, sizeof(buf), tycho::span<char>(out, 4)) == 4);
+    assert(std::string_view(out, 4) == "03ff");
+
+    auto mem = shared_mem<uint8_t>::from_hex("03ff");
+    assert(mem.size() == 2 && mem.to_hex() == "03ff");
+
+    std::string blob;
+    for (std::size_t pos = 0; pos < 10000; ++pos)
+        blob += char(pos * 131 + (pos >> 7));
+    for (auto step : {std::size_t(1), std::size_t(7), std::size_t(4096), std::size_t(10000)}) {
+        std::stringstream text;
+        {
+            b64_ostream enc(text, b64_t::url_nopad);
+            for (std::size_t pos = 0; pos < blob.size(); pos += step)
+                enc.write(blob.data() + pos, std::streamsize(std::min(step, blob.size() - pos)));
+        }
+        assert(text.str() == to_b64(reinterpret_cast<const uint8_t *>(blob.data()), blob.size(), b64_t::url_nopad));
+        b64_istream dec(text, b64_t::url_nopad);
+        const std::string result((std::istreambuf_iterator<char>(dec)), std::istreambuf_iterator<char>());
+        assert(result == blob);
+        assert(!dec.bad());
+    }
+
+    std::stringstream hex_text;
+    hex_ostream hex_enc(hex_text);
+    hex_enc << "hello" << char(0x7f);
+    assert(hex_enc.finish());
+    assert(hex_text.str() == "68656c6c6f7f");
+    hex_istream hex_dec(hex_text);
+    std::string word;
+    hex_dec >> word;
+    assert(word == "hello\x7f");
+
+    b64_decoder decoder;
+    uint8_t part[16];
+    assert(decoder.update("QUJ", part) == 0);
+    assert(decoder.update("DRFox", part) == 6);
+    assert(decoder.update("Mg==", part) == 1);
+    assert(decoder.update("QQ==", part) == 0 && !decoder);
+    decoder.reset();
+    assert(decoder.update("QUJDRF", part) == 3);
+    assert(decoder.finish(part) == 0 && !decoder);
+
+    std::stringstream bad_text("QUJD*kFa");
+    b64_istream bad_dec(bad_text);
+    bad_dec.get();
+    assert(bad_dec.bad());
 }